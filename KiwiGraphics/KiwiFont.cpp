@@ -21,13 +21,136 @@
  ==============================================================================
  */
 
-#include "KiwiFont.h"
+#include "KiwiTextRun.h"
 
 namespace Kiwi
 {
+    // ================================================================================ //
+    //                                  FONT ADVANCES                                   //
+    // ================================================================================ //
+    
+    // Keeps an element among the most recently used ones, the least recently used one is released past the limit.
+    template <class T> static void keepRecent(list<shared_ptr<T>>& recent, shared_ptr<T> const& element, const ulong limit) noexcept
+    {
+        auto it = find(recent.begin(), recent.end(), element);
+        if(it != recent.end())
+        {
+            recent.splice(recent.begin(), recent, it);
+        }
+        else
+        {
+            recent.push_front(element);
+            if(ulong(recent.size()) > limit)
+            {
+                recent.pop_back();
+            }
+        }
+    }
+    
+    // Erases the expired entries of a map of weak references, only when the map doubled since the last purge so
+    // the cost is amortized over the insertions.
+    template <class Key, class T> static void purgeExpired(map<Key, weak_ptr<T>>& entries, ulong& threshold) noexcept
+    {
+        if(ulong(entries.size()) > threshold)
+        {
+            for(auto it = entries.begin(); it != entries.end();)
+            {
+                if(it->second.expired())
+                {
+                    it = entries.erase(it);
+                }
+                else
+                {
+                    ++it;
+                }
+            }
+            threshold = max(threshold, ulong(entries.size()) * 2ul);
+        }
+    }
+    
+    double Font::Advances::find(const unsigned long c) const noexcept
+    {
+        if(c < 0x10000ul)
+        {
+            Page const* page = m_pages[c >> 8].get();
+            return page ? (*page)[c & 0xFF] : -1.;
+        }
+        auto it = m_others.find(c);
+        return it != m_others.end() ? it->second : -1.;
+    }
+    
+    bool Font::Advances::get(const unsigned long c, double& width) const noexcept
+    {
+        lock_guard<mutex> guard(m_mutex);
+        const double cached = find(c);
+        if(cached >= 0.)
+        {
+            width = cached;
+            return true;
+        }
+        return false;
+    }
+    
+    bool Font::Advances::get(wchar_t const* text, const ulong size, double* widths) const noexcept
+    {
+        bool complete = true;
+        lock_guard<mutex> guard(m_mutex);
+        for(ulong i = 0; i < size; i++)
+        {
+            widths[i] = find((unsigned long)text[i]);
+            complete  = complete && widths[i] >= 0.;
+        }
+        return complete;
+    }
+    
+    void Font::Advances::set(const unsigned long c, const double width) noexcept
+    {
+        lock_guard<mutex> guard(m_mutex);
+        if(c < 0x10000ul)
+        {
+            unique_ptr<Page>& page = m_pages[c >> 8];
+            if(!page)
+            {
+                page = unique_ptr<Page>(new Page());
+                page->fill(-1.);
+            }
+            (*page)[c & 0xFF] = width;
+        }
+        else
+        {
+            m_others[c] = width;
+        }
+    }
+    
+    shared_ptr<Font::Advances> Font::Advances::get(string const& name, const double height, const unsigned style) noexcept
+    {
+        // The advances are shared by the internal fonts and the most recently retrieved ones are also kept by the table,
+        // so the widths measured with a transient font, like a styled copy created to draw a frame, aren't lost.
+        static const ulong limit = 64ul;
+        static map<tuple<string, double, unsigned>, weak_ptr<Advances>> advances;
+        static list<shared_ptr<Advances>> recent;
+        static ulong threshold = limit * 2ul;
+        static mutex advances_mutex;
+        lock_guard<mutex> guard(advances_mutex);
+        weak_ptr<Advances>& entry = advances[make_tuple(name, height, style)];
+        shared_ptr<Advances> adv = entry.lock();
+        if(!adv)
+        {
+            adv = make_shared<Advances>();
+            entry = adv;
+            purgeExpired(advances, threshold);
+        }
+        keepRecent(recent, adv, limit);
+        return adv;
+    }
+    
+    // ================================================================================ //
+    //                                      FONT                                        //
+    // ================================================================================ //
+    
     double Font::Intern::getCharacterWidth(char const& c) const noexcept
     {
-        return 0.;
+        return getCachedCharacterWidth(wchar_t((unsigned char)c));
     }
     
     double Font::Intern::getCharacterWidth(wchar_t const& c) const noexcept
@@ -35,61 +158,309 @@ namespace Kiwi
         return 0.;
     }
     
+    double Font::Intern::getCachedCharacterWidth(wchar_t const& c) const noexcept
+    {
+        double width;
+        if(!m_advances->get((unsigned long)c, width))
+        {
+            width = getCharacterWidth(c);
+            m_advances->set((unsigned long)c, width);
+        }
+        return width;
+    }
+    
+    void Font::Intern::getCharacterWidths(wchar_t const* text, const ulong size, double* widths) const noexcept
+    {
+        // The cached widths are read with one lock, only the missing characters are measured one by one.
+        if(!m_advances->get(text, size, widths))
+        {
+            for(ulong i = 0; i < size; i++)
+            {
+                if(widths[i] < 0.)
+                {
+                    widths[i] = getCachedCharacterWidth(text[i]);
+                }
+            }
+        }
+    }
+    
     double Font::Intern::getLineWidth(string const& line) const noexcept
     {
-        return 0.;
+        vector<wchar_t> characters;
+        characters.reserve(line.size());
+        for(char32_t c : Utf8View(line))
+        {
+            characters.push_back(wchar_t(c));
+        }
+        return getLineWidth(characters.data(), ulong(characters.size()));
     }
     
     double Font::Intern::getLineWidth(wstring const& line) const noexcept
     {
-        return 0.;
+        return getLineWidth(line.data(), ulong(line.size()));
+    }
+    
+    double Font::Intern::getLineWidth(wchar_t const* line, const ulong size) const noexcept
+    {
+        vector<double> widths(size);
+        getCharacterWidths(line, size, widths.data());
+        double width = 0.;
+        for(ulong i = 0; i < size; i++)
+        {
+            width += widths[i];
+        }
+        return width;
     }
     
     Size Font::Intern::getTextSize(string const& text, const double width) const noexcept
     {
-        return Size(0., 0.);
+        vector<wchar_t> characters;
+        characters.reserve(text.size());
+        for(char32_t c : Utf8View(text))
+        {
+            characters.push_back(wchar_t(c));
+        }
+        return getTextSize(characters.data(), ulong(characters.size()), width);
     }
     
     Size Font::Intern::getTextSize(wstring const& text, const double width) const noexcept
     {
-        return Size(0., 0.);
+        return getTextSize(text.data(), ulong(text.size()), width);
     }
     
-    Font::Font() noexcept
+    Size Font::Intern::getTextSize(wchar_t const* text, const ulong size, const double width) const noexcept
     {
-        m_intern = getDefaultFont().m_intern->getNewReference();
+        if(!size)
+        {
+            return Size(0., 0.);
+        }
+        // The lines are wrapped like the text runs so the size agrees with the drawing.
+        vector<double> widths(size);
+        getCharacterWidths(text, size, widths.data());
+        const vector<TextRun::Line> lines = TextRun::getLines(text, widths.data(), size, width);
+        double maxwidth = 0.;
+        for(auto const& line : lines)
+        {
+            maxwidth = max(maxwidth, line.width);
+        }
+        return Size(maxwidth, double(lines.size()) * getHeight());
     }
     
-    Font::Font(string const& name, double height, Style style) noexcept
+    // The registry keeps weak references and the most recently used internal fonts, so the transient fonts created
+    // to draw a frame, like a styled or resized copy, are shared from one frame to the next instead of being created
+    // again. The expired keys are purged when the registry doubled since the last purge.
+    typedef map<tuple<string, double, unsigned>, weak_ptr<const Font::Intern>> FontInterns;
+    
+    static const ulong recentFontInternsLimit = 32ul;
+    
+    static FontInterns& getFontInterns() noexcept
+    {
+        static FontInterns interns;
+        return interns;
+    }
+    
+    static list<shared_ptr<const Font::Intern>>& getRecentFontInterns() noexcept
+    {
+        static list<shared_ptr<const Font::Intern>> recent;
+        return recent;
+    }
+    
+    static ulong& getFontInternsThreshold() noexcept
+    {
+        static ulong threshold = recentFontInternsLimit * 2ul;
+        return threshold;
+    }
+    
+    static mutex& getFontInternsMutex() noexcept
     {
-        auto it = getAvailableFonts().find(name);
-        if(it != getAvailableFonts().end())
+        static mutex interns_mutex;
+        return interns_mutex;
+    }
+    
+    Font::sIntern Font::intern(unique_ptr<Intern> internal) noexcept
+    {
+        if(internal)
         {
-            m_intern = move(it->second.m_intern->getNewReference());
+            FontInterns& interns = getFontInterns();
+            lock_guard<mutex> guard(getFontInternsMutex());
+            const auto key = make_tuple(internal->getName(), internal->getHeight(), internal->getStyle());
+            auto it = interns.find(key);
+            sIntern font = (it != interns.end()) ? it->second.lock() : sIntern();
+            if(!font)
+            {
+                font = sIntern(move(internal));
+                interns[key] = font;
+                purgeExpired(interns, getFontInternsThreshold());
+            }
+            keepRecent(getRecentFontInterns(), font, recentFontInternsLimit);
+            return font;
         }
-        else
+        return sIntern();
+    }
+    
+    Font::sIntern Font::intern(Intern const& model, const double height, const unsigned style) noexcept
+    {
         {
-            m_intern = getDefaultFont().m_intern->getNewReference();
+            FontInterns& interns = getFontInterns();
+            lock_guard<mutex> guard(getFontInternsMutex());
+            auto it = interns.find(make_tuple(model.getName(), clip(height, 0.1, 10000.), style));
+            if(it != interns.end())
+            {
+                sIntern font = it->second.lock();
+                if(font)
+                {
+                    keepRecent(getRecentFontInterns(), font, recentFontInternsLimit);
+                    return font;
+                }
+            }
         }
-        setHeight(height);
-        setStyle(style);
+        unique_ptr<Intern> internal = model.getNewReference();
+        internal->setHeight(height);
+        internal->setStyle(Style(style));
+        return intern(move(internal));
     }
     
-    void Font::setName(const string& name)
+    struct Font::Registry
     {
-        const double height = getHeight();
-        const Style  style  = Style(getStyle());
-        auto it = getAvailableFonts().find(name);
-        if(it != getAvailableFonts().end())
+        map<string, Font>   fonts;
+        std::set<string>    names;
+        std::set<string>    missing;
+        Resolver            resolver;
+        mutex               lock;
+    };
+    
+    Font::Registry& Font::getRegistry() noexcept
+    {
+        static Registry registry;
+        return registry;
+    }
+    
+    void Font::setResolver(vector<string> const& names, Resolver resolver) noexcept
+    {
+        Registry& registry = getRegistry();
+        lock_guard<mutex> guard(registry.lock);
+        registry.names.clear();
+        registry.names.insert(names.begin(), names.end());
+        registry.missing.clear();
+        registry.resolver = resolver;
+    }
+    
+    void Font::setAvailableFonts(vector<Font> const& fonts) noexcept
+    {
+        Registry& registry = getRegistry();
+        lock_guard<mutex> guard(registry.lock);
+        for(auto it : fonts)
+        {
+            registry.fonts[it.getName()] = it;
+            registry.names.insert(it.getName());
+        }
+    }
+    
+    Font::sIntern Font::getModel(string const& name) noexcept
+    {
+        Registry& registry = getRegistry();
+        Resolver resolver;
         {
-            m_intern = move(it->second.m_intern->getNewReference());
+            lock_guard<mutex> guard(registry.lock);
+            auto it = registry.fonts.find(name);
+            if(it != registry.fonts.end())
+            {
+                return it->second.m_intern;
+            }
+            else if(registry.missing.find(name) == registry.missing.end())
+            {
+                resolver = registry.resolver;
+            }
+        }
+        
+        // The resolver is called without the lock because it can create fonts itself.
+        unique_ptr<Intern> internal = resolver ? resolver(name) : unique_ptr<Intern>();
+        if(internal)
+        {
+            Font font(move(internal));
+            lock_guard<mutex> guard(registry.lock);
+            auto it = registry.fonts.insert(make_pair(name, font)).first;
+            registry.names.insert(name);
+            return it->second.m_intern;
+        }
+        else if(resolver)
+        {
+            lock_guard<mutex> guard(registry.lock);
+            registry.missing.insert(name);
+        }
+        return getDefaultFont().m_intern;
+    }
+    
+    map<string, Font> Font::getSystemFontsByName() noexcept
+    {
+        for(auto name : getSystemFontNames())
+        {
+            getModel(name);
+        }
+        Registry& registry = getRegistry();
+        lock_guard<mutex> guard(registry.lock);
+        return registry.fonts;
+    }
+    
+    vector<Font> Font::getSystemFonts() noexcept
+    {
+        vector<Font> fonts;
+        for(auto it : getSystemFontsByName())
+        {
+            fonts.push_back(it.second);
+        }
+        return fonts;
+    }
+    
+    vector<string> Font::getSystemFontNames() noexcept
+    {
+        Registry& registry = getRegistry();
+        lock_guard<mutex> guard(registry.lock);
+        vector<string> names;
+        for(auto name : registry.names)
+        {
+            if(registry.missing.find(name) == registry.missing.end())
+            {
+                names.push_back(name);
+            }
+        }
+        return names;
+    }
+    
+    Font::Font() noexcept : m_intern(getDefaultFont().m_intern)
+    {
+        ;
+    }
+    
+    Font::Font(string const& name, double height, Style style) noexcept
+    {
+        const sIntern model = getModel(name);
+        if(model->getHeight() == height && model->getStyle() == style)
+        {
+            m_intern = model;
         }
         else
         {
-            m_intern = getDefaultFont().m_intern->getNewReference();
+            m_intern = intern(*model, height, style);
         }
-        setHeight(height);
-        setStyle(style);
+    }
+    
+    void Font::setName(const string& name)
+    {
+        if(name != getName())
+        {
+            m_intern = intern(*getModel(name), getHeight(), getStyle());
+        }
+    }
+    
+    Size Font::getTextSize(string const& text, const double width) const noexcept
+    {
+        return TextRunCache::get(text, *this, width)->getSize();
+    }
+    
+    Size Font::getTextSize(wstring const& text, const double width) const noexcept
+    {
+        return TextRunCache::get(text, *this, width)->getSize();
     }
     
     string Font::getStyleName() const noexcept
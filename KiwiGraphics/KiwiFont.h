@@ -24,7 +24,7 @@
 #ifndef __DEF_KIWI_GUI_FONT__
 #define __DEF_KIWI_GUI_FONT__
 
-#include "KiwiColor.h"
+#include "KiwiUtf8.h"
 
 namespace Kiwi
 {
@@ -75,6 +75,66 @@ namespace Kiwi
             BoldItalicUnderlined= 7     ///< Bold/Italic/Underlined version the font.
         };
         
+        //! The advances of a font.
+        /** The advances caches the widths of the characters for a name, a height and a style. The widths of the characters of the basic multilingual plane are stored in dense pages allocated on demand, the others are stored in a hash table. The advances are shared by the internal fonts and the most recently used ones are kept alive without them, so the widths measured with a transient font are found by the next one.
+         */
+        class Advances
+        {
+        private:
+            typedef array<double, 256> Page;
+            
+            array<unique_ptr<Page>, 256>        m_pages;
+            unordered_map<unsigned long, double> m_others;
+            mutable mutex                       m_mutex;
+            
+            //! @internal
+            double find(const unsigned long c) const noexcept;
+        public:
+            
+            //! Constructor.
+            /** The function initializes an empty cache.
+             */
+            inline Advances() noexcept {}
+            
+            //! Destructor.
+            /** The function does nothing.
+             */
+            inline ~Advances() noexcept {}
+            
+            //! Retrieves the width of a character.
+            /** The function retrieves the width of a character if it has been cached.
+             @param c     The character.
+             @param width The width of the character.
+             @return true if the width has been cached, otherwise false.
+             */
+            bool get(const unsigned long c, double& width) const noexcept;
+            
+            //! Retrieves the widths of a set of characters.
+            /** The function retrieves the widths of the characters that have been cached with one lock, the widths of the other characters are set to -1.
+             @param text    The characters.
+             @param size    The number of characters.
+             @param widths  The array that receives the widths (must have the size of the number of characters).
+             @return true if all the widths have been cached, otherwise false.
+             */
+            bool get(wchar_t const* text, const ulong size, double* widths) const noexcept;
+            
+            //! Stores the width of a character.
+            /** The function stores the width of a character.
+             @param c     The character.
+             @param width The width of the character.
+             */
+            void set(const unsigned long c, const double width) noexcept;
+            
+            //! Retrieves the advances of a font.
+            /** The function retrieves the advances shared by all the fonts with the same name, height and style. The most recently retrieved advances are kept alive when no font uses them, within a limit of tables.
+             @param name    The name of the font.
+             @param height  The height of the font.
+             @param style   The style of the font.
+             @return The advances.
+             */
+            static shared_ptr<Advances> get(string const& name, const double height, const unsigned style) noexcept;
+        };
+        
         /** The internal font
          */
         class Intern
@@ -83,6 +143,7 @@ namespace Kiwi
             const string    m_name;
             double          m_height;
             unsigned        m_style;
+            shared_ptr<Advances> m_advances;
         public:
             
             //! Font constructor.
@@ -91,7 +152,7 @@ namespace Kiwi
              @param height  The height of the font.
              @param style   The style of the font.
              */
-            inline Intern(string const& name, double height, Style style) noexcept : m_name(name), m_height(height), m_style(style) {}
+            inline Intern(string const& name, double height, Style style) noexcept : m_name(name), m_height(height), m_style(style), m_advances(Advances::get(name, height, style)) {}
             
             //! Destructor.
             /** The function does nothing.
@@ -134,16 +195,36 @@ namespace Kiwi
             /** The function sets the height of the font.
              @param size The height of the font.
              */
-            virtual inline void setHeight(const double size) {m_height = clip(size, 0.1, 10000.);}
+            virtual inline void setHeight(const double size) {m_height = clip(size, 0.1, 10000.); m_advances = Advances::get(m_name, m_height, m_style);}
             
             //! Sets the font style.
             /** The function sets the style of the font.
              @param style The style of the font as a set flags.
              */
-            virtual inline void setStyle(const Style style) {m_style = style;}
+            virtual inline void setStyle(const Style style) {m_style = style; m_advances = Advances::get(m_name, m_height, m_style);}
+            
+            //! Retrieves the font ascent.
+            /** The function retrieves the distance between the baseline and the top of the font.
+             @return The ascent of the font.
+             */
+            virtual inline double getAscent() const noexcept {return getHeight() * 0.8;}
+            
+            //! Retrieves the font descent.
+            /** The function retrieves the distance between the baseline and the bottom of the font.
+             @return The descent of the font.
+             */
+            virtual inline double getDescent() const noexcept {return getHeight() * 0.2;}
+            
+            //! Retrieves the kerning of a pair of characters.
+            /** The function retrieves the adjustment of the space between two characters.
+             @param left    The left character.
+             @param right   The right character.
+             @return The kerning of the pair.
+             */
+            virtual inline double getKerning(wchar_t const& left, wchar_t const& right) const noexcept {return 0.;}
             
             //! Retrieves the width of a character.
-            /** The function retreives the width of a character for the font.
+            /** The function retreives the width of a character for the font. The default implementation uses the advances cache of the font.
              @param c The character.
              @return The width of the character.
              */
@@ -156,6 +237,21 @@ namespace Kiwi
              */
             virtual double getCharacterWidth(wchar_t const& c) const noexcept;
             
+            //! Retrieves the width of a character from the cache.
+            /** The function retrieves the width of a character from the advances cache of the font and only asks the implementation the first time.
+             @param c The character.
+             @return The width of the character.
+             */
+            double getCachedCharacterWidth(wchar_t const& c) const noexcept;
+            
+            //! Retrieves the widths of a set of characters.
+            /** The function retrieves the widths of a set of characters in one call. The default implementation uses the advances cache of the font.
+             @param text    The characters.
+             @param size    The number of characters.
+             @param widths  The array that receives the widths (must have the size of the number of characters).
+             */
+            virtual void getCharacterWidths(wchar_t const* text, const ulong size, double* widths) const noexcept;
+            
             //! Retrieves the width of a line.
             /** The function retreives the width of a line for the font.
              @param line The line.
@@ -186,9 +282,44 @@ namespace Kiwi
              */
             virtual Size getTextSize(wstring const& text, const double width = 0.) const noexcept;
             
+        protected:
+            
+            //! Retrieves the width of a set of characters.
+            /** The function measures a line with the batch of widths of the font.
+             @param line    The characters.
+             @param size    The number of characters.
+             @return The width of the line.
+             */
+            double getLineWidth(wchar_t const* line, const ulong size) const noexcept;
+            
+            //! Retrieves the size of a set of characters.
+            /** The function lays out a set of characters with the advances of the font, the lines are wrapped on the word boundaries when they exceed the width limit.
+             @param text    The characters.
+             @param size    The number of characters.
+             @param width   The width limit of the text, zero means no limits.
+             @return The size of the text.
+             */
+            Size getTextSize(wchar_t const* text, const ulong size, const double width) const noexcept;
         };
         
-        unique_ptr<Intern> m_intern;
+        //! The font resolver.
+        /** The resolver creates the internal font of a font name the first time the name is requested, it returns a null pointer if the font doesn't exist.
+         */
+        typedef function<unique_ptr<Intern>(string const& name)> Resolver;
+        
+    private:
+        typedef shared_ptr<const Intern> sIntern;
+        
+        sIntern m_intern;
+        
+        //! @internal
+        static sIntern intern(unique_ptr<Intern> internal) noexcept;
+        
+        //! @internal
+        static sIntern intern(Intern const& model, const double height, const unsigned style) noexcept;
+        
+        //! @internal
+        static sIntern getModel(string const& name) noexcept;
     public:
         
         //! Font constructor.
@@ -205,30 +336,30 @@ namespace Kiwi
         Font(string const& name, double height = 12., Style style = Regular) noexcept;
         
         //! Font constructor.
-        /** Initializes a font with an internal font.
+        /** Initializes a font with an internal font. If an internal font with the same name, height and style has already been registered, the font shares it and the new one is released.
          @param internal the internal font.
          */
-        inline Font(unique_ptr<Intern> internal) noexcept : m_intern(move(internal)) {}
+        inline Font(unique_ptr<Intern> internal) noexcept : m_intern(intern(move(internal))) {}
         
         //! Font constructor.
-        /** Initializes a with another font.
+        /** Initializes a with another font. The internal font is shared so the copy doesn't allocate.
          @param font The other font.
          */
-        inline Font(Font const& font) : m_intern(font.m_intern->getNewReference()) {}
+        inline Font(Font const& font) noexcept : m_intern(font.m_intern) {}
         
         //! Font constructor.
         /** Initializes a with another font.
          @param font The other font.
          */
-        inline Font(Font&& font) : m_intern(move(font.m_intern)) {}
+        inline Font(Font&& font) noexcept : m_intern(font.m_intern) {}
         
         //! Font equal oeprator.
-        /** Initializes the font with another font.
+        /** Initializes the font with another font. The internal font is shared so the copy doesn't allocate.
          @param other The other font.
          */
         inline Font& operator=(Font const& other) noexcept
         {
-            m_intern = other.m_intern->getNewReference();
+            m_intern = other.m_intern;
             return *this;
         }
         
@@ -238,7 +369,7 @@ namespace Kiwi
          */
         inline Font& operator=(Font&& other) noexcept
         {
-            m_intern = move(other.m_intern);
+            m_intern = other.m_intern;
             return *this;
         }
         
@@ -308,7 +439,7 @@ namespace Kiwi
         inline void setHeight(const double height)
         {
             if(height != getHeight()) {
-                m_intern->setHeight(height);}
+                m_intern = intern(*m_intern, height, getStyle());}
         }
         
         //! Sets the font style.
@@ -318,7 +449,7 @@ namespace Kiwi
         inline void setStyle(const Style style)
         {
             if(style != getStyle()) {
-                m_intern->setStyle(style);}
+                m_intern = intern(*m_intern, getHeight(), style);}
         }
         
         //! Sets the font style.
@@ -334,7 +465,7 @@ namespace Kiwi
         inline void setBold(const bool shouldBeBold) noexcept
         {
             unsigned style = getStyle();
-            shouldBeBold ? style |= Font::Bold : style &= Font::Bold;
+            shouldBeBold ? style |= Font::Bold : style &= ~unsigned(Font::Bold);
             setStyle(Style(style));
         }
         
@@ -345,7 +476,7 @@ namespace Kiwi
         inline void setItalic(const bool shouldBeItalic) noexcept
         {
             unsigned style = getStyle();
-            shouldBeItalic ? style |= Font::Italic : style &= Font::Italic;
+            shouldBeItalic ? style |= Font::Italic : style &= ~unsigned(Font::Italic);
             setStyle(Style(style));
         }
         
@@ -356,30 +487,80 @@ namespace Kiwi
         inline void setUnderline(const bool shouldBeUnderlined) noexcept
         {
             unsigned style = getStyle();
-            shouldBeUnderlined ? style |= Font::Underlined : style &= Font::Underlined;
+            shouldBeUnderlined ? style |= Font::Underlined : style &= ~unsigned(Font::Underlined);
             setStyle(Style(style));
         }
         
+        //! Retrieves a copy of the font with another height.
+        /** The function retrieves a copy of the font with another height.
+         @param height The height of the font.
+         @return The new font.
+         */
+        inline Font withHeight(const double height) const noexcept
+        {
+            Font font(*this);
+            font.setHeight(height);
+            return font;
+        }
+        
+        //! Retrieves a copy of the font with another style.
+        /** The function retrieves a copy of the font with another style.
+         @param style The style of the font as a set flags.
+         @return The new font.
+         */
+        inline Font withStyle(const Style style) const noexcept
+        {
+            Font font(*this);
+            font.setStyle(style);
+            return font;
+        }
+        
+        //! Retrieves the handle of the font.
+        /** The function retrieves the address of the internal font. Since the fonts are interned, two fonts are similar if they have the same handle.
+         @return The handle of the font.
+         */
+        inline void const* getHandle() const noexcept {return m_intern.get();}
+        
         //! Compare the font with another.
-        /** The function compare the font with another.
+        /** The function compare the font with another. Since the fonts are interned, the function only compares the internal fonts.
          @param other The other font.
          @return true is the fonts are not similar, otherwise false.
          */
         inline bool operator!=(Font const& other) const noexcept
         {
-            return getName() != other.getName() || getStyle() != other.getStyle() ||  getHeight() != other.getHeight();
+            return m_intern != other.m_intern;
         }
         
         //! Compare the font with another.
-        /** The function compare the font with another.
+        /** The function compare the font with another. Since the fonts are interned, the function only compares the internal fonts.
          @param other The other font.
          @return true is the fonts are similar, otherwise false.
          */
         inline bool operator==(Font const& other) const noexcept
         {
-            return getName() == other.getName() && getStyle() == other.getStyle() && getHeight() == other.getHeight();
+            return m_intern == other.m_intern;
         }
         
+        //! Retrieves the font ascent.
+        /** The function retrieves the distance between the baseline and the top of the font.
+         @return The ascent of the font.
+         */
+        inline double getAscent() const noexcept {return m_intern->getAscent();}
+        
+        //! Retrieves the font descent.
+        /** The function retrieves the distance between the baseline and the bottom of the font.
+         @return The descent of the font.
+         */
+        inline double getDescent() const noexcept {return m_intern->getDescent();}
+        
+        //! Retrieves the kerning of a pair of characters.
+        /** The function retrieves the adjustment of the space between two characters.
+         @param left    The left character.
+         @param right   The right character.
+         @return The kerning of the pair.
+         */
+        inline double getKerning(wchar_t const& left, wchar_t const& right) const noexcept {return m_intern->getKerning(left, right);}
+        
         //! Retrieves the width of a character.
         /** The function retreives the width of a character for the font.
          @param c The character.
@@ -397,7 +578,33 @@ namespace Kiwi
          */
         inline double getCharacterWidth(wchar_t const& c) const noexcept
         {
-            return m_intern->getCharacterWidth(c);
+            return m_intern->getCachedCharacterWidth(c);
+        }
+        
+        //! Retrieves the widths of a set of characters.
+        /** The function retrieves the widths of a set of characters in one call.
+         @param text    The characters.
+         @param size    The number of characters.
+         @param widths  The array that receives the widths (must have the size of the number of characters).
+         */
+        inline void getCharacterWidths(wchar_t const* text, const ulong size, double* widths) const noexcept
+        {
+            m_intern->getCharacterWidths(text, size, widths);
+        }
+        
+        //! Retrieves the widths of the characters of a text.
+        /** The function retrieves the widths of the characters of a text in one call.
+         @param text    The text.
+         @return The widths of the characters.
+         */
+        inline vector<double> getCharacterWidths(wstring const& text) const noexcept
+        {
+            vector<double> widths(text.size());
+            if(!text.empty())
+            {
+                m_intern->getCharacterWidths(text.data(), ulong(text.size()), widths.data());
+            }
+            return widths;
         }
         
         //! Retrieves the width of a line.
@@ -421,26 +628,20 @@ namespace Kiwi
         }
         
         //! Retrieves the size of a text.
-        /** The function the size of a text depending for the font.
+        /** The function the size of a text depending for the font. The text is laid out once and retrieved from the text run cache the next times.
          @param text The text.
          @param width The width limit of the text, zero means no limits.
          @return The width of the text.
          */
-        inline Size getTextSize(string const& text, const double width = 0.) const noexcept
-        {
-            return m_intern->getTextSize(text, width);
-        }
+        Size getTextSize(string const& text, const double width = 0.) const noexcept;
         
         //! Retrieves the size of a text.
-        /** The function the width of a text depending for the font.
+        /** The function the width of a text depending for the font. The text is laid out once and retrieved from the text run cache the next times.
          @param text The text.
          @param width The width limit of the text, zero means no limits.
          @return The width of the text.
          */
-        Size getTextSize(wstring const& text, const double width = 0.) const noexcept
-        {
-            return m_intern->getTextSize(text, width);
-        }
+        Size getTextSize(wstring const& text, const double width = 0.) const noexcept;
         
         //! Retrieve the font as a vector of atoms.
         /** The function retrieves the font as a vector of atoms.
@@ -473,15 +674,19 @@ namespace Kiwi
         
     private:
         friend class GuiDeviceManager;
+        friend class TextRun;
         
-        inline static void setAvailableFonts(vector<Font> const& fonts) noexcept
-        {
-            map<string, Font>& m_fonts = getAvailableFonts();
-            for(auto it : fonts)
-            {
-                m_fonts[(it).getName()] = (it);
-            }
-        }
+        //! @internal
+        struct Registry;
+        
+        //! @internal
+        static Registry& getRegistry() noexcept;
+        
+        //! @internal
+        static void setResolver(vector<string> const& names, Resolver resolver) noexcept;
+        
+        //! @internal
+        static void setAvailableFonts(vector<Font> const& fonts) noexcept;
         
         inline static void setDefaultFont(Font const& fonts) noexcept
         {
@@ -489,12 +694,6 @@ namespace Kiwi
             m_default = fonts;
         }
         
-        inline static map<string, Font>& getAvailableFonts() noexcept
-        {
-            static map<string, Font> m_fonts;
-            return m_fonts;
-        }
-        
         inline static Font& getDefaultFont() noexcept
         {
             static Font m_default(unique_ptr<Intern>(new Intern("Helvetica", 12., Regular)));
@@ -504,43 +703,22 @@ namespace Kiwi
     public:
         
         //! Retrieves the available fonts in the system.
-        /** The function the available fonts in the system.
+        /** The function the available fonts in the system. Since the fonts are resolved on demand, the function resolves all the fonts that haven't been requested yet.
          @return The available fonts.
          */
-        inline static map<string, Font> getSystemFontsByName() noexcept
-        {
-            return getAvailableFonts();
-        }
+        static map<string, Font> getSystemFontsByName() noexcept;
         
         //! Retrieves the available fonts in the system.
-        /** The function the available fonts in the system.
+        /** The function the available fonts in the system. Since the fonts are resolved on demand, the function resolves all the fonts that haven't been requested yet.
          @return The available fonts.
          */
-        inline static vector<Font> getSystemFonts() noexcept
-        {
-            map<string, Font>& m_fonts = getAvailableFonts();
-            vector<Font> fonts;
-            for(auto it : m_fonts)
-            {
-                fonts.push_back(it.second);
-            }
-            return fonts;
-        }
+        static vector<Font> getSystemFonts() noexcept;
         
         //! Retrieves the available font names in the system.
-        /** The function the available font names in the system.
+        /** The function the available font names in the system. The function doesn't resolve the fonts.
          @return The available font names .
          */
-        inline static vector<string> getSystemFontNames() noexcept
-        {
-            map<string, Font>& m_fonts = getAvailableFonts();
-            vector<string> fonts;
-            for(auto it : m_fonts)
-            {
-                fonts.push_back(it.first);
-            }
-            return fonts;
-        }
+        static vector<string> getSystemFontNames() noexcept;
     };
 }
 
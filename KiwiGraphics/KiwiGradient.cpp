@@ -0,0 +1,115 @@
+/*
+ ==============================================================================
+ 
+ This file is part of the KIWI library.
+ Copyright (c) 2014 Pierre Guillot & Eliott Paris.
+ 
+ Permission is granted to use this software under the terms of either:
+ a) the GPL v2 (or any later version)
+ b) the Affero GPL v3
+ 
+ Details of these licenses can be found at: www.gnu.org/licenses
+ 
+ KIWI is distributed in the hope that it will be useful, but WITHOUT ANY
+ WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ 
+ ------------------------------------------------------------------------------
+ 
+ To release a closed-source product which uses KIWI, contact : guillotpierre6@gmail.com
+ 
+ ==============================================================================
+ */
+
+#include "KiwiGradient.h"
+
+namespace Kiwi
+{
+    // ================================================================================ //
+    //                                      GRADIENT                                    //
+    // ================================================================================ //
+    
+    Gradient::Gradient(Color const& color1, Point const& start, Color const& color2, Point const& end, const Type type, const ulong resolution) noexcept :
+    m_start(start), m_end(end), m_type(type), m_resolution(max(resolution, 2ul))
+    {
+        m_stops.push_back(Stop(0., color1));
+        m_stops.push_back(Stop(1., color2));
+        build();
+    }
+    
+    void Gradient::addColor(const double offset, Color const& color) noexcept
+    {
+        const double pos = clip(offset, 0., 1.);
+        auto it = m_stops.begin();
+        while(it != m_stops.end() && it->first <= pos)
+        {
+            ++it;
+        }
+        m_stops.insert(it, Stop(pos, color));
+        build();
+    }
+    
+    void Gradient::build() noexcept
+    {
+        shared_ptr<vector<Color>> table = make_shared<vector<Color>>(m_resolution);
+        const double step = 1. / double(m_resolution - 1ul);
+        ulong index = 0ul;
+        for(ulong i = 0; i < m_resolution; i++)
+        {
+            const double pos = double(i) * step;
+            while(index + 2ul < m_stops.size() && m_stops[index + 1ul].first < pos)
+            {
+                ++index;
+            }
+            Stop const& first  = m_stops[index];
+            Stop const& second = m_stops[index + 1ul];
+            if(pos <= first.first)
+            {
+                (*table)[i] = first.second;
+            }
+            else if(pos >= second.first)
+            {
+                (*table)[i] = second.second;
+            }
+            else
+            {
+                (*table)[i] = Color::interpolate(first.second, second.second, (pos - first.first) / (second.first - first.first));
+            }
+        }
+        m_table = table;
+    }
+    
+    double Gradient::getOffsetAt(Point const& pt) const noexcept
+    {
+        if(m_type == Radial)
+        {
+            const double radius = getRadius();
+            return radius > 0. ? clip(pt.distance(m_start) / radius, 0., 1.) : 1.;
+        }
+        else
+        {
+            const Point delta = m_end - m_start;
+            const double length = delta.dot(delta);
+            return length > 0. ? clip((pt - m_start).dot(delta) / length, 0., 1.) : 1.;
+        }
+    }
+    
+    Gradient Gradient::transformed(AffineMatrix const& matrix) const noexcept
+    {
+        Gradient gradient(*this);
+        matrix.applyTo(gradient.m_start);
+        matrix.applyTo(gradient.m_end);
+        return gradient;
+    }
+    
+    Gradient& Gradient::operator=(Gradient const& other) noexcept
+    {
+        m_start     = other.m_start;
+        m_end       = other.m_end;
+        m_type      = other.m_type;
+        m_stops     = other.m_stops;
+        m_resolution= other.m_resolution;
+        m_table     = other.m_table;
+        return *this;
+    }
+}
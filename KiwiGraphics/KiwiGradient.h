@@ -0,0 +1,204 @@
+/*
+ ==============================================================================
+ 
+ This file is part of the KIWI library.
+ Copyright (c) 2014 Pierre Guillot & Eliott Paris.
+ 
+ Permission is granted to use this software under the terms of either:
+ a) the GPL v2 (or any later version)
+ b) the Affero GPL v3
+ 
+ Details of these licenses can be found at: www.gnu.org/licenses
+ 
+ KIWI is distributed in the hope that it will be useful, but WITHOUT ANY
+ WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ 
+ ------------------------------------------------------------------------------
+ 
+ To release a closed-source product which uses KIWI, contact : guillotpierre6@gmail.com
+ 
+ ==============================================================================
+ */
+
+#ifndef __DEF_KIWI_GUI_GRADIENT__
+#define __DEF_KIWI_GUI_GRADIENT__
+
+#include "KiwiColor.h"
+
+namespace Kiwi
+{
+    // ================================================================================ //
+    //                                      GRADIENT                                    //
+    // ================================================================================ //
+    
+    //! The gradient holds a set of colors distributed along a line or a circle.
+    /**
+     The gradient is defined by two points and a set of colors stops. The colors are precomputed in a lookup table the first time the gradient is used, then the table is shared by the copies of the gradient so it can be reused from one draw to another without any interpolation.
+     */
+    class Gradient
+    {
+    public:
+        
+        /** The type of gradient.
+         */
+        enum Type
+        {
+            Linear = 0, ///< The colors are distributed along the line from the start point to the end point.
+            Radial = 1  ///< The colors are distributed along the radius of the circle centered on the start point and passing through the end point.
+        };
+        
+    private:
+        typedef pair<double, Color>         Stop;
+        typedef shared_ptr<const vector<Color>> sTable;
+        
+        Point           m_start;
+        Point           m_end;
+        Type            m_type;
+        vector<Stop>    m_stops;
+        ulong           m_resolution;
+        sTable          m_table;
+        
+        //! @internal
+        void build() noexcept;
+        
+    public:
+        static const ulong defaultResolution = 256ul;
+        
+        //! Constructor.
+        /** The function initializes a gradient with two colors.
+         @param color1      The color at the start point.
+         @param start       The start point.
+         @param color2      The color at the end point.
+         @param end         The end point.
+         @param type        The type of gradient.
+         @param resolution  The number of colors of the lookup table.
+         */
+        Gradient(Color const& color1, Point const& start, Color const& color2, Point const& end, const Type type = Linear, const ulong resolution = defaultResolution) noexcept;
+        
+        //! Constructor.
+        /** The function initializes a gradient with another.
+         @param other The other gradient.
+         */
+        inline Gradient(Gradient const& other) noexcept :
+        m_start(other.m_start), m_end(other.m_end), m_type(other.m_type), m_stops(other.m_stops), m_resolution(other.m_resolution), m_table(other.m_table) {}
+        
+        //! Destructor.
+        /** The function does nothing.
+         */
+        inline ~Gradient() noexcept {}
+        
+        //! Retrieve the type of the gradient.
+        /** The function retrieves the type of the gradient.
+         @return The type.
+         */
+        inline Type getType() const noexcept {return m_type;}
+        
+        //! Retrieve if the gradient is radial.
+        /** The function retrieves if the gradient is radial.
+         @return true if the gradient is radial, otherwise false.
+         */
+        inline bool isRadial() const noexcept {return m_type == Radial;}
+        
+        //! Retrieve the start point.
+        /** The function retrieves the start point or the center of the gradient.
+         @return The start point.
+         */
+        inline Point getStart() const noexcept {return m_start;}
+        
+        //! Retrieve the end point.
+        /** The function retrieves the end point of the gradient.
+         @return The end point.
+         */
+        inline Point getEnd() const noexcept {return m_end;}
+        
+        //! Retrieve the radius.
+        /** The function retrieves the distance between the start point and the end point.
+         @return The radius.
+         */
+        inline double getRadius() const noexcept {return m_start.distance(m_end);}
+        
+        //! Retrieve the number of colors of the lookup table.
+        /** The function retrieves the number of colors of the lookup table.
+         @return The resolution of the gradient.
+         */
+        inline ulong getResolution() const noexcept {return m_resolution;}
+        
+        //! Retrieve the number of color stops.
+        /** The function retrieves the number of color stops.
+         @return The number of color stops.
+         */
+        inline ulong getNumberOfStops() const noexcept {return ulong(m_stops.size());}
+        
+        //! Retrieve the offset of a color stop.
+        /** The function retrieves the offset of a color stop.
+         @param index The index of the stop.
+         @return The offset of the stop (between 0. and 1.).
+         */
+        inline double getStopOffset(const ulong index) const noexcept {return m_stops[index].first;}
+        
+        //! Retrieve the color of a color stop.
+        /** The function retrieves the color of a color stop.
+         @param index The index of the stop.
+         @return The color of the stop.
+         */
+        inline Color getStopColor(const ulong index) const noexcept {return m_stops[index].second;}
+        
+        //! Add a color stop.
+        /** The function adds a color stop to the gradient and computes the lookup table again, the copies of the gradient keep the previous table.
+         @param offset  The offset of the color (between 0. and 1.).
+         @param color   The color.
+         */
+        void addColor(const double offset, Color const& color) noexcept;
+        
+        //! Retrieve the lookup table.
+        /** The function retrieves the precomputed colors of the gradient. The table is computed when the gradient is created or modified and then shared by the copies of the gradient, so a gradient can be read from several threads.
+         @return The colors.
+         */
+        inline vector<Color> const& getLookupTable() const noexcept {return *m_table;}
+        
+        //! Retrieve the color at an offset.
+        /** The function retrieves the color at an offset of the gradient from the lookup table.
+         @param offset  The offset (between 0. and 1.).
+         @return The color.
+         */
+        inline Color getColorAt(const double offset) const noexcept
+        {
+            vector<Color> const& table = getLookupTable();
+            return table[ulong(clip(offset, 0., 1.) * double(table.size() - 1ul) + 0.5)];
+        }
+        
+        //! Retrieve the offset of a point.
+        /** The function retrieves the offset of the gradient at a point, its projection on the line for linear gradients or its relative distance from the center for radial gradients.
+         @param pt The point.
+         @return The offset (between 0. and 1.).
+         */
+        double getOffsetAt(Point const& pt) const noexcept;
+        
+        //! Retrieve the color at a point.
+        /** The function retrieves the color of the gradient at a point.
+         @param pt The point.
+         @return The color.
+         */
+        inline Color getColorAt(Point const& pt) const noexcept
+        {
+            return getColorAt(getOffsetAt(pt));
+        }
+        
+        //! Retrieve a transformed version of the gradient.
+        /** The function retrieves a copy of the gradient with the points transformed by a matrix. The lookup table is shared with the copy.
+         @param matrix The affine matrix.
+         @return The new gradient.
+         */
+        Gradient transformed(AffineMatrix const& matrix) const noexcept;
+        
+        //! Set the gradient with another.
+        /** The function sets the gradient with another.
+         @param other The other gradient.
+         @return The gradient.
+         */
+        Gradient& operator=(Gradient const& other) noexcept;
+    };
+}
+
+#endif
@@ -0,0 +1,106 @@
+/*
+ ==============================================================================
+ 
+ This file is part of the KIWI library.
+ Copyright (c) 2014 Pierre Guillot & Eliott Paris.
+ 
+ Permission is granted to use this software under the terms of either:
+ a) the GPL v2 (or any later version)
+ b) the Affero GPL v3
+ 
+ Details of these licenses can be found at: www.gnu.org/licenses
+ 
+ KIWI is distributed in the hope that it will be useful, but WITHOUT ANY
+ WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ 
+ ------------------------------------------------------------------------------
+ 
+ To release a closed-source product which uses KIWI, contact : guillotpierre6@gmail.com
+ 
+ ==============================================================================
+ */
+
+#include "KiwiMappedFile.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Kiwi
+{
+    // ================================================================================ //
+    //                                  MAPPED FILE                                     //
+    // ================================================================================ //
+    
+#ifdef _WIN32
+    MappedFile::MappedFile(string const& path) noexcept : m_data(nullptr), m_size(0), m_handle(nullptr)
+    {
+        HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+        if(file != INVALID_HANDLE_VALUE)
+        {
+            LARGE_INTEGER size;
+            if(GetFileSizeEx(file, &size) && size.QuadPart > 0)
+            {
+                HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+                if(mapping)
+                {
+                    void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+                    if(data)
+                    {
+                        m_data   = static_cast<char const*>(data);
+                        m_size   = ulong(size.QuadPart);
+                        m_handle = mapping;
+                    }
+                    else
+                    {
+                        CloseHandle(mapping);
+                    }
+                }
+            }
+            CloseHandle(file);
+        }
+    }
+    
+    MappedFile::~MappedFile() noexcept
+    {
+        if(m_data)
+        {
+            UnmapViewOfFile(m_data);
+            CloseHandle(m_handle);
+        }
+    }
+#else
+    MappedFile::MappedFile(string const& path) noexcept : m_data(nullptr), m_size(0), m_handle(nullptr)
+    {
+        const int file = open(path.c_str(), O_RDONLY);
+        if(file >= 0)
+        {
+            struct stat infos;
+            if(fstat(file, &infos) == 0 && infos.st_size > 0)
+            {
+                void* data = mmap(nullptr, size_t(infos.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+                if(data != MAP_FAILED)
+                {
+                    m_data = static_cast<char const*>(data);
+                    m_size = ulong(infos.st_size);
+                }
+            }
+            close(file);
+        }
+    }
+    
+    MappedFile::~MappedFile() noexcept
+    {
+        if(m_data)
+        {
+            munmap(const_cast<char*>(m_data), size_t(m_size));
+        }
+    }
+#endif
+}
@@ -0,0 +1,82 @@
+/*
+ ==============================================================================
+ 
+ This file is part of the KIWI library.
+ Copyright (c) 2014 Pierre Guillot & Eliott Paris.
+ 
+ Permission is granted to use this software under the terms of either:
+ a) the GPL v2 (or any later version)
+ b) the Affero GPL v3
+ 
+ Details of these licenses can be found at: www.gnu.org/licenses
+ 
+ KIWI is distributed in the hope that it will be useful, but WITHOUT ANY
+ WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ 
+ ------------------------------------------------------------------------------
+ 
+ To release a closed-source product which uses KIWI, contact : guillotpierre6@gmail.com
+ 
+ ==============================================================================
+ */
+
+#ifndef __DEF_KIWI_GUI_MAPPED_FILE__
+#define __DEF_KIWI_GUI_MAPPED_FILE__
+
+#include "KiwiFont.h"
+
+namespace Kiwi
+{
+    // ================================================================================ //
+    //                                  MAPPED FILE                                     //
+    // ================================================================================ //
+    
+    //! The mapped file.
+    /** The mapped file maps a file in read only memory, the pages are loaded by the system when they are accessed.
+     */
+    class MappedFile
+    {
+    private:
+        char const* m_data;
+        ulong       m_size;
+        void*       m_handle;
+        
+        MappedFile(MappedFile const& other) = delete;
+        MappedFile& operator=(MappedFile const& other) = delete;
+    public:
+        
+        //! Constructor.
+        /** The function maps a file, if the file can't be opened the mapped file is empty.
+         @param path The path of the file.
+         */
+        MappedFile(string const& path) noexcept;
+        
+        //! Destructor.
+        /** The function unmaps the file.
+         */
+        ~MappedFile() noexcept;
+        
+        //! Retrieves if the file has been mapped.
+        /** The function retrieves if the file has been mapped.
+         @return true if the file has been mapped, otherwise false.
+         */
+        inline bool isValid() const noexcept {return m_data != nullptr;}
+        
+        //! Retrieves the data of the file.
+        /** The function retrieves the data of the file.
+         @return The data of the file.
+         */
+        inline char const* getData() const noexcept {return m_data;}
+        
+        //! Retrieves the size of the file.
+        /** The function retrieves the size of the file in bytes.
+         @return The size of the file.
+         */
+        inline ulong getSize() const noexcept {return m_size;}
+    };
+    
+    typedef shared_ptr<const MappedFile> scMappedFile;
+}
+
+#endif
@@ -24,7 +24,7 @@
 #ifndef __DEF_KIWI_GUI_MOUSECURSOR__
 #define __DEF_KIWI_GUI_MOUSECURSOR__
 
-#include "KiwiFont.h"
+#include "KiwiTextRun.h"
 
 namespace Kiwi
 {
@@ -24,7 +24,7 @@
 #ifndef __DEF_KIWI_GUI_PATH__
 #define __DEF_KIWI_GUI_PATH__
 
-#include "KiwiRectangle.h"
+#include "KiwiRegion.h"
 
 // Todo : (dashed line support, other shapes ?)
 namespace Kiwi
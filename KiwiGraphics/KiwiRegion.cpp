@@ -0,0 +1,223 @@
+/*
+ ==============================================================================
+ 
+ This file is part of the KIWI library.
+ Copyright (c) 2014 Pierre Guillot & Eliott Paris.
+ 
+ Permission is granted to use this software under the terms of either:
+ a) the GPL v2 (or any later version)
+ b) the Affero GPL v3
+ 
+ Details of these licenses can be found at: www.gnu.org/licenses
+ 
+ KIWI is distributed in the hope that it will be useful, but WITHOUT ANY
+ WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ 
+ ------------------------------------------------------------------------------
+ 
+ To release a closed-source product which uses KIWI, contact : guillotpierre6@gmail.com
+ 
+ ==============================================================================
+ */
+
+
+#include "KiwiRegion.h"
+
+namespace Kiwi
+{
+    // ================================================================================ //
+    //                                      REGION                                      //
+    // ================================================================================ //
+    
+    // Unlike Rectangle::overlaps, the rectangles that only touch by an edge don't intersect.
+    static inline bool intersects(Rectangle const& a, Rectangle const& b) noexcept
+    {
+        return a.left() < b.right() && b.left() < a.right() && a.top() < b.bottom() && b.top() < a.bottom();
+    }
+    
+    // Appends the parts of a rectangle that are outside a hole, at most four bands.
+    static void subtract(Rectangle const& rect, Rectangle const& hole, vector<Rectangle>& parts) noexcept
+    {
+        const double top    = max(rect.top(), hole.top());
+        const double bottom = min(rect.bottom(), hole.bottom());
+        if(rect.top() < top)
+        {
+            parts.push_back(Rectangle::withEdges(rect.left(), rect.top(), rect.right(), top));
+        }
+        if(bottom < rect.bottom())
+        {
+            parts.push_back(Rectangle::withEdges(rect.left(), bottom, rect.right(), rect.bottom()));
+        }
+        if(rect.left() < hole.left())
+        {
+            parts.push_back(Rectangle::withEdges(rect.left(), top, hole.left(), bottom));
+        }
+        if(hole.right() < rect.right())
+        {
+            parts.push_back(Rectangle::withEdges(hole.right(), top, rect.right(), bottom));
+        }
+    }
+    
+    Rectangle Region::getBounds() const noexcept
+    {
+        if(m_rectangles.empty())
+        {
+            return Rectangle();
+        }
+        double left = m_rectangles[0].left(), top = m_rectangles[0].top();
+        double right = m_rectangles[0].right(), bottom = m_rectangles[0].bottom();
+        for(auto const& rect : m_rectangles)
+        {
+            left    = min(left, rect.left());
+            top     = min(top, rect.top());
+            right   = max(right, rect.right());
+            bottom  = max(bottom, rect.bottom());
+        }
+        return Rectangle::withEdges(left, top, right, bottom);
+    }
+    
+    double Region::getArea() const noexcept
+    {
+        double area = 0.;
+        for(auto const& rect : m_rectangles)
+        {
+            area += rect.width() * rect.height();
+        }
+        return area;
+    }
+    
+    void Region::add(Rectangle const& rect) noexcept
+    {
+        if(rect.width() <= 0. || rect.height() <= 0.)
+        {
+            return;
+        }
+        for(auto const& it : m_rectangles)
+        {
+            if(it.contains(rect))
+            {
+                return;
+            }
+        }
+        
+        // The rectangles covered by the new one are removed, the new one is cut by the others.
+        m_rectangles.erase(remove_if(m_rectangles.begin(), m_rectangles.end(), [&rect](Rectangle const& it)
+                                     {
+                                         return rect.contains(it);
+                                     }), m_rectangles.end());
+        vector<Rectangle> parts(1, rect), next;
+        for(auto const& it : m_rectangles)
+        {
+            next.clear();
+            for(auto const& part : parts)
+            {
+                if(intersects(part, it))
+                {
+                    subtract(part, it, next);
+                }
+                else
+                {
+                    next.push_back(part);
+                }
+            }
+            parts.swap(next);
+            if(parts.empty())
+            {
+                return;
+            }
+        }
+        m_rectangles.insert(m_rectangles.end(), parts.begin(), parts.end());
+        simplify();
+    }
+    
+    void Region::add(Region const& other) noexcept
+    {
+        for(auto const& rect : other.m_rectangles)
+        {
+            add(rect);
+        }
+    }
+    
+    void Region::clip(Rectangle const& rect) noexcept
+    {
+        vector<Rectangle> rectangles;
+        for(auto const& it : m_rectangles)
+        {
+            if(intersects(it, rect))
+            {
+                rectangles.push_back(it.withClippedEdges(rect.left(), rect.top(), rect.right(), rect.bottom()));
+            }
+        }
+        m_rectangles.swap(rectangles);
+    }
+    
+    void Region::translate(Point const& delta) noexcept
+    {
+        for(auto& rect : m_rectangles)
+        {
+            rect += delta;
+        }
+    }
+    
+    bool Region::contains(Point const& pt) const noexcept
+    {
+        for(auto const& rect : m_rectangles)
+        {
+            if(rect.contains(pt))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+    
+    bool Region::overlaps(Rectangle const& rect) const noexcept
+    {
+        for(auto const& it : m_rectangles)
+        {
+            if(intersects(it, rect))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+    
+    void Region::simplify() noexcept
+    {
+        bool merged = true;
+        while(merged)
+        {
+            merged = false;
+            for(ulong i = 0; i < m_rectangles.size() && !merged; i++)
+            {
+                Rectangle& a = m_rectangles[i];
+                for(ulong j = i + 1; j < m_rectangles.size() && !merged; j++)
+                {
+                    Rectangle const& b = m_rectangles[j];
+                    if(a.left() == b.left() && a.right() == b.right() && (a.bottom() == b.top() || b.bottom() == a.top()))
+                    {
+                        a = Rectangle::withEdges(a.left(), min(a.top(), b.top()), a.right(), max(a.bottom(), b.bottom()));
+                        merged = true;
+                    }
+                    else if(a.top() == b.top() && a.bottom() == b.bottom() && (a.right() == b.left() || b.right() == a.left()))
+                    {
+                        a = Rectangle::withEdges(min(a.left(), b.left()), a.top(), max(a.right(), b.right()), a.bottom());
+                        merged = true;
+                    }
+                    if(merged)
+                    {
+                        m_rectangles.erase(m_rectangles.begin() + long(j));
+                    }
+                }
+            }
+        }
+        if(m_rectangles.size() > limit)
+        {
+            const Rectangle bounds = getBounds();
+            m_rectangles.assign(1, bounds);
+        }
+    }
+}
+
@@ -0,0 +1,137 @@
+/*
+ ==============================================================================
+ 
+ This file is part of the KIWI library.
+ Copyright (c) 2014 Pierre Guillot & Eliott Paris.
+ 
+ Permission is granted to use this software under the terms of either:
+ a) the GPL v2 (or any later version)
+ b) the Affero GPL v3
+ 
+ Details of these licenses can be found at: www.gnu.org/licenses
+ 
+ KIWI is distributed in the hope that it will be useful, but WITHOUT ANY
+ WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ 
+ ------------------------------------------------------------------------------
+ 
+ To release a closed-source product which uses KIWI, contact : guillotpierre6@gmail.com
+ 
+ ==============================================================================
+ */
+
+
+#ifndef __DEF_KIWI_GUI_REGION__
+#define __DEF_KIWI_GUI_REGION__
+
+#include "KiwiRectangle.h"
+
+namespace Kiwi
+{
+    // ================================================================================ //
+    //                                      REGION                                      //
+    // ================================================================================ //
+    
+    //! The region is an area made of disjoint rectangles.
+    /**
+     The region is used to accumulate the damaged areas of a view, the rectangles added are cut so the region never covers the same point twice and the neighbouring rectangles are fused. When the region becomes too fragmented, it's simplified to its bounds.
+     */
+    class Region
+    {
+    private:
+        vector<Rectangle> m_rectangles;
+        
+        //! @internal Fuses the rectangles that share an edge and limits the number of rectangles.
+        void simplify() noexcept;
+    public:
+        
+        //! The maximum number of rectangles before the region is simplified to its bounds.
+        static const ulong limit = 32ul;
+        
+        //! Constructor.
+        /** The function initializes an empty region.
+         */
+        inline Region() noexcept {}
+        
+        //! Constructor.
+        /** The function initializes a region with a rectangle.
+         @param rect The rectangle.
+         */
+        inline Region(Rectangle const& rect) noexcept {add(rect);}
+        
+        //! Destructor.
+        /** The function does nothing.
+         */
+        inline ~Region() noexcept {}
+        
+        //! Retrieves if the region is empty.
+        /** The function retrieves if the region doesn't cover any area.
+         @return true if the region is empty, otherwise false.
+         */
+        inline bool isEmpty() const noexcept {return m_rectangles.empty();}
+        
+        //! Retrieves the rectangles of the region.
+        /** The function retrieves the disjoint rectangles that cover the region.
+         @return The rectangles.
+         */
+        inline vector<Rectangle> const& getRectangles() const noexcept {return m_rectangles;}
+        
+        //! Retrieves the bounds of the region.
+        /** The function retrieves the smallest rectangle that contains the region.
+         @return The bounds.
+         */
+        Rectangle getBounds() const noexcept;
+        
+        //! Retrieves the area of the region.
+        /** The function retrieves the area covered by the region.
+         @return The area.
+         */
+        double getArea() const noexcept;
+        
+        //! Clears the region.
+        /** The function removes all the rectangles of the region.
+         */
+        inline void clear() noexcept {m_rectangles.clear();}
+        
+        //! Adds a rectangle to the region.
+        /** The function adds the part of a rectangle that isn't already covered by the region.
+         @param rect The rectangle.
+         */
+        void add(Rectangle const& rect) noexcept;
+        
+        //! Adds a region to the region.
+        /** The function makes the union of the region with another one.
+         @param other The other region.
+         */
+        void add(Region const& other) noexcept;
+        
+        //! Clips the region.
+        /** The function removes the parts of the region outside a rectangle.
+         @param rect The rectangle.
+         */
+        void clip(Rectangle const& rect) noexcept;
+        
+        //! Moves the region.
+        /** The function moves all the rectangles of the region.
+         @param delta The displacement.
+         */
+        void translate(Point const& delta) noexcept;
+        
+        //! Get if the region contains a point.
+        /** The function retrieves if one of the rectangles of the region contains a point.
+         @param pt The point.
+         @return true if the region contains the point, otherwise false.
+         */
+        bool contains(Point const& pt) const noexcept;
+        
+        //! Get if the region overlaps a rectangle.
+        /** The function retrieves if the region and a rectangle share an area.
+         @param rect The rectangle.
+         @return true if the region overlaps the rectangle, otherwise false.
+         */
+        bool overlaps(Rectangle const& rect) const noexcept;
+    };
+}
+
+#endif
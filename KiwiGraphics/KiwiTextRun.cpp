@@ -0,0 +1,281 @@
+/*
+ ==============================================================================
+ 
+ This file is part of the KIWI library.
+ Copyright (c) 2014 Pierre Guillot & Eliott Paris.
+ 
+ Permission is granted to use this software under the terms of either:
+ a) the GPL v2 (or any later version)
+ b) the Affero GPL v3
+ 
+ Details of these licenses can be found at: www.gnu.org/licenses
+ 
+ KIWI is distributed in the hope that it will be useful, but WITHOUT ANY
+ WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ 
+ ------------------------------------------------------------------------------
+ 
+ To release a closed-source product which uses KIWI, contact : guillotpierre6@gmail.com
+ 
+ ==============================================================================
+ */
+
+
+#include "KiwiTextRun.h"
+
+namespace Kiwi
+{
+    // ================================================================================ //
+    //                                      TEXT RUN                                    //
+    // ================================================================================ //
+    
+    TextRun::TextRun(Utf8View const& text, Font const& font, const double width, const Font::Justification justification) noexcept :
+    m_text(text.str()), m_font(font), m_width(width), m_justification(justification)
+    {
+        // Decodes the characters and keeps their byte offsets for the ranges of the lines.
+        vector<wchar_t> characters;
+        vector<ulong>   offsets;
+        characters.reserve(text.size());
+        offsets.reserve(text.size() + 1);
+        for(auto it = text.begin(); it != text.end(); ++it)
+        {
+            offsets.push_back(ulong(it.getPosition() - text.data()));
+            characters.push_back(wchar_t(*it));
+        }
+        offsets.push_back(ulong(text.size()));
+        
+        vector<double> widths(characters.size());
+        if(!characters.empty())
+        {
+            font.getCharacterWidths(characters.data(), ulong(characters.size()), widths.data());
+        }
+        
+        // The lines are broken on the characters and their ranges are converted in bytes.
+        m_lines = getLines(characters.data(), widths.data(), ulong(characters.size()), width);
+        for(auto& line : m_lines)
+        {
+            line.start = offsets[line.start];
+            line.end   = offsets[line.end];
+        }
+        
+        // The size is derived from the lines so it always agrees with the layout.
+        const double limit = width > 0. ? width : 0.;
+        double maxwidth = 0.;
+        for(auto& l : m_lines)
+        {
+            maxwidth = max(maxwidth, l.width);
+            if(limit > 0. && justification & Font::Right)
+            {
+                l.offset = limit - l.width;
+            }
+            else if(limit > 0. && justification & Font::HorizontallyCentered)
+            {
+                l.offset = (limit - l.width) * 0.5;
+            }
+        }
+        
+        m_size = text.empty() ? Size(0., 0.) : Size(maxwidth, double(m_lines.size()) * font.getHeight());
+    }
+    
+    vector<TextRun::Line> TextRun::getLines(wchar_t const* text, double const* widths, const ulong size, const double width) noexcept
+    {
+        vector<Line> lines;
+        Line    line        = {0ul, 0ul, 0., 0.};
+        double  trimmed     = 0.;   // The width of the line without its last spaces.
+        bool    breakable   = false;
+        ulong   breakpos    = 0ul;  // The first character after the last space of the line.
+        double  breakwidth  = 0.;   // The width of the line until the last space.
+        double  breaktrim   = 0.;   // The width of the line before the last spaces.
+        for(ulong i = 0; i < size; i++)
+        {
+            const wchar_t c = text[i];
+            if(c == L'\n')
+            {
+                line.end = i;
+                lines.push_back(line);
+                line.start  = i + 1;
+                line.width  = 0.;
+                trimmed     = 0.;
+                breakable   = false;
+                continue;
+            }
+            
+            const bool space = c == L' ' || c == L'\t';
+            if(!space && width > 0. && line.width > 0. && line.width + widths[i] > width)
+            {
+                if(breakable)
+                {
+                    // The last word is moved to the next line.
+                    line.end = breakpos;
+                    const double remaining = line.width - breakwidth;
+                    line.width = breaktrim;
+                    lines.push_back(line);
+                    line.start  = breakpos;
+                    line.width  = remaining;
+                    trimmed     = remaining;
+                    breakable   = false;
+                }
+                if(line.width > 0. && line.width + widths[i] > width)
+                {
+                    // The word doesn't fit in a line so it is broken between two characters.
+                    line.end = i;
+                    lines.push_back(line);
+                    line.start  = i;
+                    line.width  = 0.;
+                    trimmed     = 0.;
+                }
+            }
+            
+            line.width += widths[i];
+            if(space)
+            {
+                breakable   = true;
+                breakpos    = i + 1;
+                breakwidth  = line.width;
+                breaktrim   = trimmed;
+            }
+            else
+            {
+                trimmed = line.width;
+            }
+        }
+        line.end = size;
+        lines.push_back(line);
+        return lines;
+    }
+    
+    // ================================================================================ //
+    //                                  TEXT RUN CACHE                                  //
+    // ================================================================================ //
+    
+    struct TextRunCacheState
+    {
+        typedef list<pair<size_t, scTextRun>> Runs;
+        
+        Runs                                        runs;
+        unordered_multimap<size_t, Runs::iterator>  index;
+        ulong                                       bytes   = 0;
+        ulong                                       budget  = 1ul << 20;
+        atomic<ulong>                               hits;
+        atomic<ulong>                               misses;
+        mutex                                       lock;
+        
+        TextRunCacheState() noexcept : hits(0), misses(0) {}
+        
+        void shrink() noexcept
+        {
+            while(bytes > budget && !runs.empty())
+            {
+                auto range = index.equal_range(runs.back().first);
+                for(auto it = range.first; it != range.second; ++it)
+                {
+                    if(it->second == prev(runs.end()))
+                    {
+                        index.erase(it);
+                        break;
+                    }
+                }
+                bytes -= runs.back().second->getMemorySize();
+                runs.pop_back();
+            }
+        }
+    };
+    
+    static TextRunCacheState& getTextRunCacheState() noexcept
+    {
+        static TextRunCacheState state;
+        return state;
+    }
+    
+    // Retrieves a run from the cache with the hash of its text, the function compares the texts of the runs with the
+    // same hash and creates the run if it is missing.
+    template <class Equal, class Create> static scTextRun getTextRun(size_t hash, Font const& font, const double width, const Font::Justification justification, Equal equal, Create create) noexcept
+    {
+        TextRunCacheState& state = getTextRunCacheState();
+        hash ^= std::hash<void const*>()(font.getHandle()) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+        hash ^= std::hash<double>()(width) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+        hash ^= size_t(justification) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+        {
+            lock_guard<mutex> guard(state.lock);
+            auto range = state.index.equal_range(hash);
+            for(auto it = range.first; it != range.second; ++it)
+            {
+                TextRun const& run = *(it->second->second);
+                if(run.getFont() == font && run.getWidthLimit() == width && run.getJustification() == justification && equal(Utf8View(run.getText())))
+                {
+                    state.runs.splice(state.runs.begin(), state.runs, it->second);
+                    state.hits++;
+                    return state.runs.front().second;
+                }
+            }
+        }
+        
+        // The layout is done without the lock, if two threads lay out the same run the duplicate is released with the budget.
+        state.misses++;
+        scTextRun run = create();
+        lock_guard<mutex> guard(state.lock);
+        state.runs.push_front(make_pair(hash, run));
+        state.index.insert(make_pair(hash, state.runs.begin()));
+        state.bytes += run->getMemorySize();
+        state.shrink();
+        return run;
+    }
+    
+    scTextRun TextRunCache::get(Utf8View const& text, Font const& font, const double width, const Font::Justification justification) noexcept
+    {
+        return getTextRun(text.hash(), font, width, justification,
+                          [&text](Utf8View const& other) {return other == text;},
+                          [&]() {return make_shared<TextRun>(text, font, width, justification);});
+    }
+    
+    scTextRun TextRunCache::get(wstring const& text, Font const& font, const double width, const Font::Justification justification) noexcept
+    {
+        return getTextRun(Utf8View::hash(text.data(), ulong(text.size())), font, width, justification,
+                          [&text](Utf8View const& other) {return other.equals(text.data(), ulong(text.size()));},
+                          [&]() {return make_shared<TextRun>(Utf8View::fromWide(text), font, width, justification);});
+    }
+    
+    void TextRunCache::setBudget(const ulong bytes) noexcept
+    {
+        TextRunCacheState& state = getTextRunCacheState();
+        lock_guard<mutex> guard(state.lock);
+        state.budget = bytes;
+        state.shrink();
+    }
+    
+    ulong TextRunCache::getBudget() noexcept
+    {
+        TextRunCacheState& state = getTextRunCacheState();
+        lock_guard<mutex> guard(state.lock);
+        return state.budget;
+    }
+    
+    ulong TextRunCache::getMemorySize() noexcept
+    {
+        TextRunCacheState& state = getTextRunCacheState();
+        lock_guard<mutex> guard(state.lock);
+        return state.bytes;
+    }
+    
+    ulong TextRunCache::getHits() noexcept
+    {
+        return getTextRunCacheState().hits;
+    }
+    
+    ulong TextRunCache::getMisses() noexcept
+    {
+        return getTextRunCacheState().misses;
+    }
+    
+    void TextRunCache::clear() noexcept
+    {
+        TextRunCacheState& state = getTextRunCacheState();
+        lock_guard<mutex> guard(state.lock);
+        state.runs.clear();
+        state.index.clear();
+        state.bytes  = 0;
+        state.hits   = 0;
+        state.misses = 0;
+    }
+}
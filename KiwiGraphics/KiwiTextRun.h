@@ -0,0 +1,204 @@
+/*
+ ==============================================================================
+ 
+ This file is part of the KIWI library.
+ Copyright (c) 2014 Pierre Guillot & Eliott Paris.
+ 
+ Permission is granted to use this software under the terms of either:
+ a) the GPL v2 (or any later version)
+ b) the Affero GPL v3
+ 
+ Details of these licenses can be found at: www.gnu.org/licenses
+ 
+ KIWI is distributed in the hope that it will be useful, but WITHOUT ANY
+ WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ 
+ ------------------------------------------------------------------------------
+ 
+ To release a closed-source product which uses KIWI, contact : guillotpierre6@gmail.com
+ 
+ ==============================================================================
+ */
+
+
+#ifndef __DEF_KIWI_GUI_TEXT_RUN__
+#define __DEF_KIWI_GUI_TEXT_RUN__
+
+#include "KiwiTrueTypeFont.h"
+
+namespace Kiwi
+{
+    // ================================================================================ //
+    //                                      TEXT RUN                                    //
+    // ================================================================================ //
+    
+    class TextRun;
+    typedef shared_ptr<const TextRun> scTextRun;
+    
+    //! The text run.
+    /** The text run is a text laid out with a font for a width limit and a justification. The lines are wrapped on the word boundaries. It holds the line breaks, the widths and the offsets of the lines and the size of the text. The runs are shared by the text run cache.
+     */
+    class TextRun
+    {
+    public:
+        
+        //! A line of a text run.
+        /** The line is defined by the range of bytes of the text, its width and its horizontal offset that depends on the justification.
+         */
+        struct Line
+        {
+            ulong   start;
+            ulong   end;
+            double  width;
+            double  offset;
+        };
+        
+    private:
+        const string                m_text;
+        const Font                  m_font;
+        const double                m_width;
+        const Font::Justification   m_justification;
+        vector<Line>                m_lines;
+        Size                        m_size;
+    public:
+        
+        //! Constructor.
+        /** The function lays out a text.
+         @param text            The text in UTF-8.
+         @param font            The font.
+         @param width           The width limit of the text, zero means no limits.
+         @param justification   The justification.
+         */
+        TextRun(Utf8View const& text, Font const& font, const double width, const Font::Justification justification) noexcept;
+        
+        //! Destructor.
+        /** The function does nothing.
+         */
+        inline ~TextRun() noexcept {}
+        
+        //! Breaks a set of characters in lines.
+        /** The function breaks a set of characters at the new lines and, when a line exceeds the width limit, after the last space of the line. A word longer than the width limit is broken between two characters. The spaces at the end of a wrapped line aren't counted in its width.
+         @param text    The characters.
+         @param widths  The widths of the characters.
+         @param size    The number of characters.
+         @param width   The width limit, zero means no limits.
+         @return The lines with the ranges of characters and their widths, the offsets are null.
+         */
+        static vector<Line> getLines(wchar_t const* text, double const* widths, const ulong size, const double width) noexcept;
+        
+        //! Retrieves the text.
+        /** The function retrieves the text of the run.
+         @return The text.
+         */
+        inline string const& getText() const noexcept {return m_text;}
+        
+        //! Retrieves the font.
+        /** The function retrieves the font of the run.
+         @return The font.
+         */
+        inline Font const& getFont() const noexcept {return m_font;}
+        
+        //! Retrieves the width limit.
+        /** The function retrieves the width limit of the run.
+         @return The width limit.
+         */
+        inline double getWidthLimit() const noexcept {return m_width;}
+        
+        //! Retrieves the justification.
+        /** The function retrieves the justification of the run.
+         @return The justification.
+         */
+        inline Font::Justification getJustification() const noexcept {return m_justification;}
+        
+        //! Retrieves the lines.
+        /** The function retrieves the lines of the run.
+         @return The lines.
+         */
+        inline vector<Line> const& getLines() const noexcept {return m_lines;}
+        
+        //! Retrieves the size.
+        /** The function retrieves the size of the run.
+         @return The size.
+         */
+        inline Size getSize() const noexcept {return m_size;}
+        
+        //! Retrieves the memory used by the run.
+        /** The function retrieves an estimation of the number of bytes used by the run.
+         @return The number of bytes.
+         */
+        inline ulong getMemorySize() const noexcept
+        {
+            return ulong(sizeof(TextRun) + m_text.capacity() + m_lines.capacity() * sizeof(Line));
+        }
+    };
+    
+    // ================================================================================ //
+    //                                  TEXT RUN CACHE                                  //
+    // ================================================================================ //
+    
+    //! The text run cache.
+    /** The text run cache keeps the last used text runs so the texts that are measured or drawn every frame are only laid out once. The least recently used runs are released when the memory budget is exceeded.
+     */
+    class TextRunCache
+    {
+    public:
+        
+        //! Retrieves a text run.
+        /** The function retrieves the text run of a text from the cache or lays it out and stores it. The text is only copied when the run is created.
+         @param text            The text in UTF-8.
+         @param font            The font.
+         @param width           The width limit of the text, zero means no limits.
+         @param justification   The justification.
+         @return The text run.
+         */
+        static scTextRun get(Utf8View const& text, Font const& font, const double width = 0., const Font::Justification justification = Font::TopLeft) noexcept;
+        
+        //! Retrieves a text run.
+        /** The function retrieves the text run of a wide text from the cache or lays it out and stores it. The wide text is hashed and compared without any conversion, it is only converted when the run is created.
+         @param text            The wide text.
+         @param font            The font.
+         @param width           The width limit of the text, zero means no limits.
+         @param justification   The justification.
+         @return The text run.
+         */
+        static scTextRun get(wstring const& text, Font const& font, const double width = 0., const Font::Justification justification = Font::TopLeft) noexcept;
+        
+        //! Sets the memory budget.
+        /** The function sets the maximum number of bytes used by the runs of the cache.
+         @param bytes The number of bytes.
+         */
+        static void setBudget(const ulong bytes) noexcept;
+        
+        //! Retrieves the memory budget.
+        /** The function retrieves the maximum number of bytes used by the runs of the cache.
+         @return The number of bytes.
+         */
+        static ulong getBudget() noexcept;
+        
+        //! Retrieves the memory used.
+        /** The function retrieves the number of bytes currently used by the runs of the cache.
+         @return The number of bytes.
+         */
+        static ulong getMemorySize() noexcept;
+        
+        //! Retrieves the number of hits.
+        /** The function retrieves the number of times a run has been found in the cache.
+         @return The number of hits.
+         */
+        static ulong getHits() noexcept;
+        
+        //! Retrieves the number of misses.
+        /** The function retrieves the number of times a run has been laid out.
+         @return The number of misses.
+         */
+        static ulong getMisses() noexcept;
+        
+        //! Clears the cache.
+        /** The function releases all the runs and resets the counters.
+         */
+        static void clear() noexcept;
+    };
+}
+
+#endif
@@ -0,0 +1,333 @@
+/*
+ ==============================================================================
+ 
+ This file is part of the KIWI library.
+ Copyright (c) 2014 Pierre Guillot & Eliott Paris.
+ 
+ Permission is granted to use this software under the terms of either:
+ a) the GPL v2 (or any later version)
+ b) the Affero GPL v3
+ 
+ Details of these licenses can be found at: www.gnu.org/licenses
+ 
+ KIWI is distributed in the hope that it will be useful, but WITHOUT ANY
+ WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ 
+ ------------------------------------------------------------------------------
+ 
+ To release a closed-source product which uses KIWI, contact : guillotpierre6@gmail.com
+ 
+ ==============================================================================
+ */
+
+
+#include "KiwiTrueTypeFont.h"
+
+namespace Kiwi
+{
+    // ================================================================================ //
+    //                                  TRUETYPE FONT                                   //
+    // ================================================================================ //
+    
+    // All the values of a TrueType file are big endian, out of range reads return zero.
+    static inline ulong readUInt16(MappedFile const& file, const ulong offset) noexcept
+    {
+        if(offset + 2 > file.getSize())
+        {
+            return 0;
+        }
+        unsigned char const* data = reinterpret_cast<unsigned char const*>(file.getData()) + offset;
+        return (ulong(data[0]) << 8) | ulong(data[1]);
+    }
+    
+    static inline long readInt16(MappedFile const& file, const ulong offset) noexcept
+    {
+        return long(int16_t(uint16_t(readUInt16(file, offset))));
+    }
+    
+    static inline ulong readUInt32(MappedFile const& file, const ulong offset) noexcept
+    {
+        return (readUInt16(file, offset) << 16) | readUInt16(file, offset + 2);
+    }
+    
+    static ulong findTable(MappedFile const& file, char const* tag, ulong& length) noexcept
+    {
+        const ulong ntables = readUInt16(file, 4);
+        for(ulong i = 0; i < ntables; i++)
+        {
+            const ulong record = 12 + i * 16;
+            if(record + 16 <= file.getSize() && memcmp(file.getData() + record, tag, 4) == 0)
+            {
+                const ulong offset = readUInt32(file, record + 8);
+                length = readUInt32(file, record + 12);
+                if(offset + length <= file.getSize())
+                {
+                    return offset;
+                }
+            }
+        }
+        length = 0;
+        return 0;
+    }
+    
+    shared_ptr<const TrueTypeFont::Tables> TrueTypeFont::read(scMappedFile file) noexcept
+    {
+        if(!file || !file->isValid() || file->getSize() < 12)
+        {
+            return nullptr;
+        }
+        MappedFile const& f = *file;
+        const ulong version = readUInt32(f, 0);
+        if(version != 0x00010000ul && version != 0x4F54544Ful && version != 0x74727565ul)
+        {
+            return nullptr;
+        }
+        
+        ulong head_size, hhea_size, hmtx_size, maxp_size, cmap_size, kern_size;
+        const ulong head = findTable(f, "head", head_size);
+        const ulong hhea = findTable(f, "hhea", hhea_size);
+        const ulong hmtx = findTable(f, "hmtx", hmtx_size);
+        const ulong maxp = findTable(f, "maxp", maxp_size);
+        const ulong cmap = findTable(f, "cmap", cmap_size);
+        const ulong kern = findTable(f, "kern", kern_size);
+        if(head_size < 54 || hhea_size < 36 || !hmtx_size || maxp_size < 6 || cmap_size < 4)
+        {
+            return nullptr;
+        }
+        
+        shared_ptr<Tables> tables = make_shared<Tables>();
+        tables->file            = file;
+        tables->units_per_em    = readUInt16(f, head + 18);
+        tables->ascent          = double(readInt16(f, hhea + 4));
+        tables->descent         = -double(readInt16(f, hhea + 6));
+        tables->nmetrics        = min(readUInt16(f, hhea + 34), hmtx_size / 4);
+        tables->hmtx            = hmtx;
+        tables->nglyphs         = readUInt16(f, maxp + 4);
+        if(!tables->units_per_em || !tables->nmetrics)
+        {
+            return nullptr;
+        }
+        
+        // Prefers the full unicode subtables (format 12) to the basic multilingual plane ones (format 4).
+        int score = 0;
+        const ulong nsubtables = readUInt16(f, cmap + 2);
+        for(ulong i = 0; i < nsubtables && 4 + i * 8 + 8 <= cmap_size; i++)
+        {
+            const ulong platform = readUInt16(f, cmap + 4 + i * 8);
+            const ulong encoding = readUInt16(f, cmap + 4 + i * 8 + 2);
+            const ulong offset   = cmap + readUInt32(f, cmap + 4 + i * 8 + 4);
+            const ulong format   = readUInt16(f, offset);
+            const bool unicode   = platform == 0 || (platform == 3 && (encoding == 1 || encoding == 10));
+            if(unicode && offset < cmap + cmap_size)
+            {
+                const int current = format == 12 ? 2 : (format == 4 ? 1 : 0);
+                if(current > score)
+                {
+                    score = current;
+                    tables->cmap = offset;
+                    tables->cmap_format = format;
+                }
+            }
+        }
+        if(!score)
+        {
+            return nullptr;
+        }
+        
+        // Only the first horizontal subtable of format 0 of the Microsoft kern table is used.
+        if(kern_size >= 4 && readUInt16(f, kern) == 0)
+        {
+            const ulong nsubtables = readUInt16(f, kern + 2);
+            ulong offset = kern + 4;
+            for(ulong i = 0; i < nsubtables && offset + 14 <= kern + kern_size; i++)
+            {
+                const ulong length   = readUInt16(f, offset + 2);
+                const ulong coverage = readUInt16(f, offset + 4);
+                if((coverage >> 8) == 0 && (coverage & 0x1) && !(coverage & 0x4))
+                {
+                    tables->nkern_pairs = min(readUInt16(f, offset + 6), (kern + kern_size - offset - 14) / 6);
+                    tables->kern_pairs  = offset + 14;
+                    break;
+                }
+                if(!length)
+                {
+                    break;
+                }
+                offset += length;
+            }
+        }
+        return tables;
+    }
+    
+    unique_ptr<TrueTypeFont> TrueTypeFont::load(string const& path, string const& name, double height, Font::Style style) noexcept
+    {
+        shared_ptr<const Tables> tables = read(make_shared<MappedFile>(path));
+        if(tables)
+        {
+            string fname = name;
+            if(fname.empty())
+            {
+                const string::size_type start = path.find_last_of("/\\");
+                fname = path.substr(start == string::npos ? 0 : start + 1);
+                fname = fname.substr(0, fname.find_last_of('.'));
+            }
+            return unique_ptr<TrueTypeFont>(new TrueTypeFont(tables, fname, clip(height, 0.1, 10000.), style));
+        }
+        return nullptr;
+    }
+    
+    unique_ptr<Font::Intern> TrueTypeFont::getNewReference() const noexcept
+    {
+        return unique_ptr<Font::Intern>(new TrueTypeFont(m_tables, getName(), getHeight(), Font::Style(getStyle())));
+    }
+    
+    ulong TrueTypeFont::getGlyph(const ulong c) const noexcept
+    {
+        MappedFile const& f = *m_tables->file;
+        const ulong cmap = m_tables->cmap;
+        if(m_tables->cmap_format == 4)
+        {
+            if(c > 0xFFFF)
+            {
+                return 0;
+            }
+            const ulong nsegments = readUInt16(f, cmap + 6) / 2;
+            const ulong ends      = cmap + 14;
+            const ulong starts    = ends + nsegments * 2 + 2;
+            const ulong deltas    = starts + nsegments * 2;
+            const ulong ranges    = deltas + nsegments * 2;
+            
+            // Looks for the first segment that ends after the character.
+            ulong low = 0, high = nsegments;
+            while(low < high)
+            {
+                const ulong mid = (low + high) / 2;
+                if(readUInt16(f, ends + mid * 2) < c)
+                {
+                    low = mid + 1;
+                }
+                else
+                {
+                    high = mid;
+                }
+            }
+            if(low < nsegments)
+            {
+                const ulong start = readUInt16(f, starts + low * 2);
+                if(start <= c)
+                {
+                    const ulong delta = readUInt16(f, deltas + low * 2);
+                    const ulong range = readUInt16(f, ranges + low * 2);
+                    if(!range)
+                    {
+                        return (c + delta) & 0xFFFF;
+                    }
+                    const ulong glyph = readUInt16(f, ranges + low * 2 + range + (c - start) * 2);
+                    return glyph ? (glyph + delta) & 0xFFFF : 0;
+                }
+            }
+        }
+        else if(m_tables->cmap_format == 12)
+        {
+            const ulong ngroups = readUInt32(f, cmap + 12);
+            ulong low = 0, high = ngroups;
+            while(low < high)
+            {
+                const ulong mid   = (low + high) / 2;
+                const ulong group = cmap + 16 + mid * 12;
+                if(readUInt32(f, group + 4) < c)
+                {
+                    low = mid + 1;
+                }
+                else if(readUInt32(f, group) > c)
+                {
+                    high = mid;
+                }
+                else
+                {
+                    return readUInt32(f, group + 8) + (c - readUInt32(f, group));
+                }
+            }
+        }
+        return 0;
+    }
+    
+    double TrueTypeFont::getAdvance(const ulong glyph) const noexcept
+    {
+        const ulong metric = min(glyph < m_tables->nglyphs ? glyph : 0ul, m_tables->nmetrics - 1);
+        return double(readUInt16(*m_tables->file, m_tables->hmtx + metric * 4)) * getHeight() / double(m_tables->units_per_em);
+    }
+    
+    double TrueTypeFont::getAscent() const noexcept
+    {
+        return m_tables->ascent * getHeight() / double(m_tables->units_per_em);
+    }
+    
+    double TrueTypeFont::getDescent() const noexcept
+    {
+        return m_tables->descent * getHeight() / double(m_tables->units_per_em);
+    }
+    
+    double TrueTypeFont::getKerning(wchar_t const& left, wchar_t const& right) const noexcept
+    {
+        if(m_tables->nkern_pairs)
+        {
+            const ulong key = (getGlyph(ulong(left)) << 16) | getGlyph(ulong(right));
+            ulong low = 0, high = m_tables->nkern_pairs;
+            while(low < high)
+            {
+                const ulong mid  = (low + high) / 2;
+                const ulong pair = m_tables->kern_pairs + mid * 6;
+                const ulong current = readUInt32(*m_tables->file, pair);
+                if(current < key)
+                {
+                    low = mid + 1;
+                }
+                else if(current > key)
+                {
+                    high = mid;
+                }
+                else
+                {
+                    return double(readInt16(*m_tables->file, pair + 4)) * getHeight() / double(m_tables->units_per_em);
+                }
+            }
+        }
+        return 0.;
+    }
+    
+    double TrueTypeFont::getCharacterWidth(char const& c) const noexcept
+    {
+        return getAdvance(getGlyph(ulong((unsigned char)c)));
+    }
+    
+    double TrueTypeFont::getCharacterWidth(wchar_t const& c) const noexcept
+    {
+        return getAdvance(getGlyph(ulong(c)));
+    }
+    
+    void TrueTypeFont::getCharacterWidths(wchar_t const* text, const ulong size, double* widths) const noexcept
+    {
+        Font::Intern::getCharacterWidths(text, size, widths);
+        if(m_tables->nkern_pairs)
+        {
+            for(ulong i = 1; i < size; i++)
+            {
+                widths[i-1] += getKerning(text[i-1], text[i]);
+            }
+        }
+    }
+    
+    double TrueTypeFont::getLineWidth(wstring const& line) const noexcept
+    {
+        vector<double> widths(line.size());
+        getCharacterWidths(line.data(), ulong(line.size()), widths.data());
+        double width = 0.;
+        for(auto w : widths)
+        {
+            width += w;
+        }
+        return width;
+    }
+}
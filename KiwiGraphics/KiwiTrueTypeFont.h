@@ -0,0 +1,154 @@
+/*
+ ==============================================================================
+ 
+ This file is part of the KIWI library.
+ Copyright (c) 2014 Pierre Guillot & Eliott Paris.
+ 
+ Permission is granted to use this software under the terms of either:
+ a) the GPL v2 (or any later version)
+ b) the Affero GPL v3
+ 
+ Details of these licenses can be found at: www.gnu.org/licenses
+ 
+ KIWI is distributed in the hope that it will be useful, but WITHOUT ANY
+ WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ 
+ ------------------------------------------------------------------------------
+ 
+ To release a closed-source product which uses KIWI, contact : guillotpierre6@gmail.com
+ 
+ ==============================================================================
+ */
+
+#ifndef __DEF_KIWI_GUI_TRUETYPE_FONT__
+#define __DEF_KIWI_GUI_TRUETYPE_FONT__
+
+#include "KiwiMappedFile.h"
+
+namespace Kiwi
+{
+    // ================================================================================ //
+    //                                  TRUETYPE FONT                                   //
+    // ================================================================================ //
+    
+    //! The TrueType font.
+    /** The TrueType font is an internal font that only reads the metrics of a TrueType or OpenType file without any platform backend. The file is mapped in memory and the cmap, head, hhea, hmtx and kern tables are read in place, so only the pages that are accessed are loaded.
+     */
+    class TrueTypeFont : public Font::Intern
+    {
+    private:
+        
+        //! @internal
+        struct Tables
+        {
+            scMappedFile    file;
+            ulong           units_per_em    = 0;
+            ulong           nglyphs         = 0;
+            double          ascent          = 0.;
+            double          descent         = 0.;
+            ulong           nmetrics        = 0;
+            ulong           hmtx            = 0;
+            ulong           cmap            = 0;
+            ulong           cmap_format     = 0;
+            ulong           kern_pairs      = 0;
+            ulong           nkern_pairs     = 0;
+        };
+        
+        const shared_ptr<const Tables> m_tables;
+        
+        //! @internal
+        inline TrueTypeFont(shared_ptr<const Tables> tables, string const& name, double height, Font::Style style) noexcept :
+        Font::Intern(name, height, style), m_tables(tables) {}
+        
+        //! @internal
+        static shared_ptr<const Tables> read(scMappedFile file) noexcept;
+        
+        //! @internal
+        ulong getGlyph(const ulong c) const noexcept;
+        
+        //! @internal
+        double getAdvance(const ulong glyph) const noexcept;
+    public:
+        
+        //! Loads a TrueType font.
+        /** The function maps a TrueType or OpenType file and reads its metrics.
+         @param path    The path of the file.
+         @param name    The name of the font, if the name is empty the name of the file is used.
+         @param height  The height of the font.
+         @param style   The style of the font.
+         @return The internal font or a null pointer if the file isn't a valid font.
+         */
+        static unique_ptr<TrueTypeFont> load(string const& path, string const& name = string(), double height = 12., Font::Style style = Font::Regular) noexcept;
+        
+        //! Destructor.
+        /** The function does nothing.
+         */
+        inline ~TrueTypeFont() noexcept {}
+        
+        //! Retrieves if the font is available in the system.
+        /** The function retrieves if the font has been read.
+         @return true if the font is available otherwise false.
+         */
+        inline bool isValid() const noexcept override {return bool(m_tables);}
+        
+        //! Retrieves a new reference of the font.
+        /** The function retrieves a new reference of the font that shares the mapped file.
+         @return The new reference.
+         */
+        unique_ptr<Font::Intern> getNewReference() const noexcept override;
+        
+        //! Retrieves the font ascent.
+        /** The function retrieves the distance between the baseline and the top of the font.
+         @return The ascent of the font.
+         */
+        double getAscent() const noexcept override;
+        
+        //! Retrieves the font descent.
+        /** The function retrieves the distance between the baseline and the bottom of the font.
+         @return The descent of the font.
+         */
+        double getDescent() const noexcept override;
+        
+        //! Retrieves the kerning of a pair of characters.
+        /** The function retrieves the adjustment of the space between two characters from the kern table.
+         @param left    The left character.
+         @param right   The right character.
+         @return The kerning of the pair.
+         */
+        double getKerning(wchar_t const& left, wchar_t const& right) const noexcept override;
+        
+        //! Retrieves the width of a character.
+        /** The function retreives the width of a character for the font.
+         @param c The character.
+         @return The width of the character.
+         */
+        double getCharacterWidth(char const& c) const noexcept override;
+        
+        //! Retrieves the width of a character.
+        /** The function retreives the width of a character for the font.
+         @param c The character.
+         @return The width of the character.
+         */
+        double getCharacterWidth(wchar_t const& c) const noexcept override;
+        
+        //! Retrieves the widths of a set of characters.
+        /** The function retrieves the widths of a set of characters, the kerning with the next character is added to the width of each character.
+         @param text    The characters.
+         @param size    The number of characters.
+         @param widths  The array that receives the widths (must have the size of the number of characters).
+         */
+        void getCharacterWidths(wchar_t const* text, const ulong size, double* widths) const noexcept override;
+        
+        //! Retrieves the width of a line.
+        /** The function retreives the width of a line for the font.
+         @param line The line.
+         @return The width of the line.
+         */
+        double getLineWidth(wstring const& line) const noexcept override;
+        
+        using Font::Intern::getLineWidth;
+    };
+}
+
+#endif
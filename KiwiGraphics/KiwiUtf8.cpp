@@ -0,0 +1,150 @@
+/*
+ ==============================================================================
+ 
+ This file is part of the KIWI library.
+ Copyright (c) 2014 Pierre Guillot & Eliott Paris.
+ 
+ Permission is granted to use this software under the terms of either:
+ a) the GPL v2 (or any later version)
+ b) the Affero GPL v3
+ 
+ Details of these licenses can be found at: www.gnu.org/licenses
+ 
+ KIWI is distributed in the hope that it will be useful, but WITHOUT ANY
+ WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ 
+ ------------------------------------------------------------------------------
+ 
+ To release a closed-source product which uses KIWI, contact : guillotpierre6@gmail.com
+ 
+ ==============================================================================
+ */
+
+
+#include "KiwiUtf8.h"
+
+namespace Kiwi
+{
+    // ================================================================================ //
+    //                                      UTF-8 VIEW                                  //
+    // ================================================================================ //
+    
+    // Decodes the code point of a wide text at a position and moves the position to the next one, the UTF-16
+    // surrogate pairs are combined when wide characters are 16 bits.
+    static char32_t decodeWide(wchar_t const*& pos, wchar_t const* end) noexcept
+    {
+        char32_t code = char32_t(*pos++);
+        if(sizeof(wchar_t) == 2 && code >= 0xD800 && code < 0xDC00 && pos != end)
+        {
+            const char32_t low = char32_t(*pos);
+            if(low >= 0xDC00 && low < 0xE000)
+            {
+                code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                ++pos;
+            }
+        }
+        return code < 0x110000 ? code : char32_t(0xFFFD);
+    }
+    
+    ulong Utf8View::length() const noexcept
+    {
+        ulong length = 0;
+        for(auto it = begin(); it != end(); ++it)
+        {
+            length++;
+        }
+        return length;
+    }
+    
+    void Utf8View::encode(const char32_t code, string& text) noexcept
+    {
+        if(code < 0x80)
+        {
+            text.push_back(char(code));
+        }
+        else if(code < 0x800)
+        {
+            text.push_back(char(0xC0 | (code >> 6)));
+            text.push_back(char(0x80 | (code & 0x3F)));
+        }
+        else if(code < 0x10000)
+        {
+            text.push_back(char(0xE0 | (code >> 12)));
+            text.push_back(char(0x80 | ((code >> 6) & 0x3F)));
+            text.push_back(char(0x80 | (code & 0x3F)));
+        }
+        else if(code < 0x110000)
+        {
+            text.push_back(char(0xF0 | (code >> 18)));
+            text.push_back(char(0x80 | ((code >> 12) & 0x3F)));
+            text.push_back(char(0x80 | ((code >> 6) & 0x3F)));
+            text.push_back(char(0x80 | (code & 0x3F)));
+        }
+        else
+        {
+            encode(char32_t(0xFFFD), text);
+        }
+    }
+    
+    size_t Utf8View::hash(wchar_t const* text, const ulong size) noexcept
+    {
+        // The bytes are encoded in a small buffer so the hash matches the one of the converted text.
+        uint64_t hash = 14695981039346656037ull;
+        string bytes;
+        bytes.reserve(4);
+        for(wchar_t const* pos = text, *end = text + size; pos != end;)
+        {
+            bytes.clear();
+            encode(decodeWide(pos, end), bytes);
+            for(auto c : bytes)
+            {
+                hash = (hash ^ (unsigned char)c) * 1099511628211ull;
+            }
+        }
+        return size_t(hash);
+    }
+    
+    bool Utf8View::equals(wchar_t const* text, const ulong size) const noexcept
+    {
+        wchar_t const* pos = text, *end = text + size;
+        for(char32_t code : *this)
+        {
+            if(pos == end || decodeWide(pos, end) != code)
+            {
+                return false;
+            }
+        }
+        return pos == end;
+    }
+    
+    string Utf8View::fromWide(wstring const& text) noexcept
+    {
+        string result;
+        result.reserve(text.size());
+        for(wchar_t const* pos = text.data(), *end = text.data() + text.size(); pos != end;)
+        {
+            encode(decodeWide(pos, end), result);
+        }
+        return result;
+    }
+    
+    wstring Utf8View::toWide(Utf8View const& text) noexcept
+    {
+        wstring result;
+        result.reserve(text.size());
+        for(char32_t code : text)
+        {
+            if(sizeof(wchar_t) == 2 && code >= 0x10000)
+            {
+                result.push_back(wchar_t(0xD800 + ((code - 0x10000) >> 10)));
+                result.push_back(wchar_t(0xDC00 + ((code - 0x10000) & 0x3FF)));
+            }
+            else
+            {
+                result.push_back(wchar_t(code));
+            }
+        }
+        return result;
+    }
+}
@@ -0,0 +1,301 @@
+/*
+ ==============================================================================
+ 
+ This file is part of the KIWI library.
+ Copyright (c) 2014 Pierre Guillot & Eliott Paris.
+ 
+ Permission is granted to use this software under the terms of either:
+ a) the GPL v2 (or any later version)
+ b) the Affero GPL v3
+ 
+ Details of these licenses can be found at: www.gnu.org/licenses
+ 
+ KIWI is distributed in the hope that it will be useful, but WITHOUT ANY
+ WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ 
+ ------------------------------------------------------------------------------
+ 
+ To release a closed-source product which uses KIWI, contact : guillotpierre6@gmail.com
+ 
+ ==============================================================================
+ */
+
+
+#ifndef __DEF_KIWI_GUI_UTF8__
+#define __DEF_KIWI_GUI_UTF8__
+
+#include "KiwiGradient.h"
+
+namespace Kiwi
+{
+    // ================================================================================ //
+    //                                      UTF-8 VIEW                                  //
+    // ================================================================================ //
+    
+    //! The UTF-8 view.
+    /** The UTF-8 view refers to a range of UTF-8 bytes owned by a string or a buffer without copying them. Its iterator decodes the code points in place so a text can be measured or drawn without any conversion. The invalid sequences are decoded as the replacement character.
+     */
+    class Utf8View
+    {
+    private:
+        char const* m_data;
+        ulong       m_size;
+    public:
+        
+        //! The iterator.
+        /** The iterator moves from a code point to the next one and decodes the current code point on dereference.
+         */
+        class Iterator
+        {
+        private:
+            char const* m_pos;
+            char const* m_end;
+        public:
+            
+            //! Constructor.
+            /** The function initializes an iterator at a position of a range.
+             @param pos The position.
+             @param end The end of the range.
+             */
+            inline Iterator(char const* pos, char const* end) noexcept : m_pos(pos), m_end(end) {}
+            
+            //! Retrieves the current code point.
+            /** The function decodes the code point at the current position.
+             @return The code point.
+             */
+            inline char32_t operator*() const noexcept
+            {
+                char const* pos = m_pos;
+                return decode(pos, m_end);
+            }
+            
+            //! Moves to the next code point.
+            /** The function moves to the next code point.
+             @return The iterator.
+             */
+            inline Iterator& operator++() noexcept
+            {
+                m_pos += getSequenceSize(m_pos, m_end);
+                return *this;
+            }
+            
+            //! Retrieves the current position.
+            /** The function retrieves the address of the first byte of the current code point.
+             @return The address.
+             */
+            inline char const* getPosition() const noexcept {return m_pos;}
+            
+            //! Compares the iterator with another.
+            /** The function compares the positions of the iterators.
+             @param other The other iterator.
+             @return true if the iterators are at the same position, otherwise false.
+             */
+            inline bool operator==(Iterator const& other) const noexcept {return m_pos == other.m_pos;}
+            
+            //! Compares the iterator with another.
+            /** The function compares the positions of the iterators.
+             @param other The other iterator.
+             @return true if the iterators are not at the same position, otherwise false.
+             */
+            inline bool operator!=(Iterator const& other) const noexcept {return m_pos != other.m_pos;}
+        };
+        
+        //! Constructor.
+        /** The function initializes an empty view.
+         */
+        inline Utf8View() noexcept : m_data(nullptr), m_size(0) {}
+        
+        //! Constructor.
+        /** The function initializes a view of a range of bytes.
+         @param data The address of the first byte.
+         @param size The number of bytes.
+         */
+        inline Utf8View(char const* data, const ulong size) noexcept : m_data(data), m_size(size) {}
+        
+        //! Constructor.
+        /** The function initializes a view of a null terminated string.
+         @param data The string.
+         */
+        inline Utf8View(char const* data) noexcept : m_data(data), m_size(data ? ulong(strlen(data)) : 0ul) {}
+        
+        //! Constructor.
+        /** The function initializes a view of a string, the string must outlive the view.
+         @param text The string.
+         */
+        inline Utf8View(string const& text) noexcept : m_data(text.data()), m_size(ulong(text.size())) {}
+        
+        //! Retrieves the data.
+        /** The function retrieves the address of the first byte of the view.
+         @return The address.
+         */
+        inline char const* data() const noexcept {return m_data;}
+        
+        //! Retrieves the size.
+        /** The function retrieves the number of bytes of the view.
+         @return The number of bytes.
+         */
+        inline ulong size() const noexcept {return m_size;}
+        
+        //! Retrieves if the view is empty.
+        /** The function retrieves if the view has no bytes.
+         @return true if the view is empty, otherwise false.
+         */
+        inline bool empty() const noexcept {return m_size == 0ul;}
+        
+        //! Retrieves an iterator to the first code point.
+        /** The function retrieves an iterator to the first code point.
+         @return The iterator.
+         */
+        inline Iterator begin() const noexcept {return Iterator(m_data, m_data + m_size);}
+        
+        //! Retrieves an iterator after the last code point.
+        /** The function retrieves an iterator after the last code point.
+         @return The iterator.
+         */
+        inline Iterator end() const noexcept {return Iterator(m_data + m_size, m_data + m_size);}
+        
+        //! Retrieves a part of the view.
+        /** The function retrieves a view of a range of bytes of the view.
+         @param pos The offset of the first byte.
+         @param size The number of bytes.
+         @return The view.
+         */
+        inline Utf8View substr(const ulong pos, const ulong size = ulong(-1)) const noexcept
+        {
+            const ulong start = min(pos, m_size);
+            return Utf8View(m_data + start, min(size, m_size - start));
+        }
+        
+        //! Retrieves the view as a string.
+        /** The function copies the bytes of the view in a string.
+         @return The string.
+         */
+        inline string str() const noexcept {return string(m_data, m_size);}
+        
+        //! Retrieves the hash of the view.
+        /** The function computes a FNV-1a hash of the bytes of the view.
+         @return The hash.
+         */
+        inline size_t hash() const noexcept
+        {
+            uint64_t hash = 14695981039346656037ull;
+            for(ulong i = 0; i < m_size; i++)
+            {
+                hash = (hash ^ (unsigned char)m_data[i]) * 1099511628211ull;
+            }
+            return size_t(hash);
+        }
+        
+        //! Retrieves the hash of a wide text.
+        /** The function computes the hash of the UTF-8 conversion of a wide text without converting it, so a wide text and its conversion have the same hash.
+         @param text The wide characters.
+         @param size The number of wide characters.
+         @return The hash.
+         */
+        static size_t hash(wchar_t const* text, const ulong size) noexcept;
+        
+        //! Compares the view with a wide text.
+        /** The function compares the code points of the view with the ones of a wide text without converting it.
+         @param text The wide characters.
+         @param size The number of wide characters.
+         @return true if the view is the UTF-8 conversion of the wide text, otherwise false.
+         */
+        bool equals(wchar_t const* text, const ulong size) const noexcept;
+        
+        //! Compares the view with another.
+        /** The function compares the bytes of the views.
+         @param other The other view.
+         @return true if the views have the same bytes, otherwise false.
+         */
+        inline bool operator==(Utf8View const& other) const noexcept
+        {
+            return m_size == other.m_size && (m_size == 0 || memcmp(m_data, other.m_data, m_size) == 0);
+        }
+        
+        //! Retrieves the number of code points.
+        /** The function counts the code points of the view.
+         @return The number of code points.
+         */
+        ulong length() const noexcept;
+        
+        //! Retrieves the size of a sequence.
+        /** The function retrieves the number of bytes of the code point at a position, an invalid sequence has a size of one.
+         @param pos The position.
+         @param end The end of the range.
+         @return The number of bytes.
+         */
+        static inline ulong getSequenceSize(char const* pos, char const* end) noexcept
+        {
+            const unsigned char c = (unsigned char)*pos;
+            const ulong size = c < 0x80 ? 1 : (c >> 5) == 0x6 ? 2 : (c >> 4) == 0xE ? 3 : (c >> 3) == 0x1E ? 4 : 1;
+            if(size > 1)
+            {
+                if(ulong(end - pos) < size)
+                {
+                    return 1;
+                }
+                for(ulong i = 1; i < size; i++)
+                {
+                    if(((unsigned char)pos[i] & 0xC0) != 0x80)
+                    {
+                        return 1;
+                    }
+                }
+            }
+            return size;
+        }
+        
+        //! Decodes a code point.
+        /** The function decodes the code point at a position and moves the position to the next one.
+         @param pos The position.
+         @param end The end of the range.
+         @return The code point.
+         */
+        static inline char32_t decode(char const*& pos, char const* end) noexcept
+        {
+            const unsigned char c = (unsigned char)*pos;
+            if(c < 0x80)
+            {
+                ++pos;
+                return char32_t(c);
+            }
+            const ulong size = getSequenceSize(pos, end);
+            if(size == 1)
+            {
+                ++pos;
+                return char32_t(0xFFFD);
+            }
+            char32_t code = char32_t(c & (0x7F >> size));
+            for(ulong i = 1; i < size; i++)
+            {
+                code = (code << 6) | char32_t((unsigned char)pos[i] & 0x3F);
+            }
+            pos += size;
+            return code;
+        }
+        
+        //! Encodes a code point.
+        /** The function appends the UTF-8 sequence of a code point to a string.
+         @param code The code point.
+         @param text The string.
+         */
+        static void encode(const char32_t code, string& text) noexcept;
+        
+        //! Converts a wide string.
+        /** The function converts a wide string in UTF-8, the UTF-16 surrogate pairs are combined when wide characters are 16 bits.
+         @param text The wide string.
+         @return The UTF-8 string.
+         */
+        static string fromWide(wstring const& text) noexcept;
+        
+        //! Converts a view in a wide string.
+        /** The function converts a UTF-8 view in a wide string, the code points are split in UTF-16 surrogate pairs when wide characters are 16 bits.
+         @param text The view.
+         @return The wide string.
+         */
+        static wstring toWide(Utf8View const& text) noexcept;
+    };
+}
+
+#endif
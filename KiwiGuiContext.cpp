@@ -23,6 +23,7 @@
 
 #include "KiwiGuiContext.h"
 #include "KiwiGuiDevice.h"
+#include <chrono>
 
 namespace Kiwi
 {
@@ -30,8 +31,223 @@ namespace Kiwi
     //                                  GUI CONTEXT                                     //
     // ================================================================================ //
 	
+    // The blinker toggles the phase of all the objects on one timer, a new object restarts the phase visible and the
+    // timer isn't rescheduled once there is no object left.
+    class GuiContext::Blinker : public Clock
+    {
+    private:
+        set<wBlinkable, owner_less<wBlinkable>> m_items;
+        mutex                                   m_mutex;
+        bool                                    m_visible;
+        bool                                    m_running;
+    public:
+        
+        Blinker() noexcept : m_visible(true), m_running(false) {}
+        
+        void add(sBlinkable item) noexcept
+        {
+            vector<sBlinkable> items;
+            {
+                lock_guard<mutex> guard(m_mutex);
+                m_items.insert(item);
+                m_visible = true;
+                for(auto it : m_items)
+                {
+                    sBlinkable blinkable = it.lock();
+                    if(blinkable)
+                    {
+                        items.push_back(blinkable);
+                    }
+                }
+                if(!m_running)
+                {
+                    m_running = true;
+                    delay(500.);
+                }
+            }
+            for(auto it : items)
+            {
+                it->blink(true);
+            }
+        }
+        
+        void remove(sBlinkable item) noexcept
+        {
+            lock_guard<mutex> guard(m_mutex);
+            m_items.erase(item);
+        }
+        
+        void tick() override
+        {
+            vector<sBlinkable> items;
+            bool visible;
+            {
+                lock_guard<mutex> guard(m_mutex);
+                for(auto it = m_items.begin(); it != m_items.end();)
+                {
+                    sBlinkable blinkable = it->lock();
+                    if(blinkable)
+                    {
+                        items.push_back(blinkable);
+                        ++it;
+                    }
+                    else
+                    {
+                        it = m_items.erase(it);
+                    }
+                }
+                m_visible = !m_visible;
+                visible   = m_visible;
+                m_running = !items.empty();
+                if(m_running)
+                {
+                    delay(500.);
+                }
+            }
+            for(auto it : items)
+            {
+                it->blink(visible);
+            }
+        }
+    };
+    
+    static double getGuiContextTime() noexcept
+    {
+        return chrono::duration<double, milli>(chrono::steady_clock::now().time_since_epoch()).count();
+    }
+    
+    // The scheduler collects the requests of a frame and delivers them together on one timer, the timer is only
+    // scheduled when there is a request and never before a period after the previous frame.
+    class GuiContext::Scheduler : public Clock
+    {
+    private:
+        struct Layout
+        {
+            bool moved;
+            bool resized;
+        };
+        
+        map<wGuiView, Region, owner_less<wGuiView>> m_redraws;
+        map<wGuiView, Layout, owner_less<wGuiView>> m_layouts;
+        map<ulong, FrameCallback>                   m_callbacks;
+        ulong                                       m_request;
+        double                                      m_period;
+        double                                      m_last;
+        bool                                        m_pending;
+        mutable mutex                               m_mutex;
+        
+        //! @internal Must be called with the lock.
+        void schedule() noexcept
+        {
+            if(!m_pending)
+            {
+                m_pending = true;
+                delay(max(0., m_last + m_period - getGuiContextTime()));
+            }
+        }
+        
+    public:
+        
+        Scheduler() noexcept : m_request(0ul), m_period(1000. / 60.), m_last(0.), m_pending(false) {}
+        
+        void setPeriod(const double period) noexcept
+        {
+            lock_guard<mutex> guard(m_mutex);
+            m_period = period;
+        }
+        
+        double getPeriod() const noexcept
+        {
+            lock_guard<mutex> guard(m_mutex);
+            return m_period;
+        }
+        
+        ulong request(FrameCallback callback) noexcept
+        {
+            lock_guard<mutex> guard(m_mutex);
+            m_callbacks[++m_request] = callback;
+            schedule();
+            return m_request;
+        }
+        
+        void cancel(const ulong request) noexcept
+        {
+            lock_guard<mutex> guard(m_mutex);
+            m_callbacks.erase(request);
+        }
+        
+        void redraw(sGuiView view, Rectangle const& area) noexcept
+        {
+            lock_guard<mutex> guard(m_mutex);
+            m_redraws[view].add(area);
+            schedule();
+        }
+        
+        void layout(sGuiView view, const bool moved, const bool resized) noexcept
+        {
+            lock_guard<mutex> guard(m_mutex);
+            auto it = m_layouts.insert(make_pair(wGuiView(view), Layout{false, false})).first;
+            it->second.moved   = it->second.moved || moved;
+            it->second.resized = it->second.resized || resized;
+            schedule();
+        }
+        
+        void tick() override
+        {
+            map<wGuiView, Region, owner_less<wGuiView>> redraws;
+            map<wGuiView, Layout, owner_less<wGuiView>> layouts;
+            map<ulong, FrameCallback>                   callbacks;
+            double time;
+            {
+                // The requests made during the frame are delivered at the next one.
+                lock_guard<mutex> guard(m_mutex);
+                swap(redraws, m_redraws);
+                swap(layouts, m_layouts);
+                swap(callbacks, m_callbacks);
+                m_pending = false;
+                m_last    = time = getGuiContextTime();
+            }
+            for(auto const& it : callbacks)
+            {
+                it.second(time);
+            }
+            for(auto const& it : layouts)
+            {
+                sGuiView view = it.first.lock();
+                if(view)
+                {
+                    if(!it.second.resized)
+                    {
+                        view->positionChanged();
+                    }
+                    else if(!it.second.moved)
+                    {
+                        view->sizeChanged();
+                    }
+                    else
+                    {
+                        view->boundsChanged();
+                    }
+                }
+            }
+            for(auto const& it : redraws)
+            {
+                sGuiView view = it.first.lock();
+                if(view)
+                {
+                    for(auto const& rect : it.second.getRectangles())
+                    {
+                        view->redraw(rect);
+                    }
+                }
+            }
+        }
+    };
+    
     GuiContext::GuiContext(sGuiDeviceManager device) noexcept :
-    m_device(device)
+    m_device(device),
+    m_blinker(make_shared<Blinker>()),
+    m_scheduler(make_shared<Scheduler>())
     {
         ;
     }
@@ -84,6 +300,38 @@ namespace Kiwi
         }
     }
     
+    void GuiContext::setTheme(GuiTheme const& theme) noexcept
+    {
+        m_theme = theme;
+        redrawTopLevels();
+    }
+    
+    void GuiContext::setThemeColor(const GuiTheme::Role role, Color const& color) noexcept
+    {
+        const ulong version = m_theme.getVersion();
+        m_theme.setColor(role, color);
+        if(version != m_theme.getVersion())
+        {
+            redrawTopLevels();
+        }
+    }
+    
+    void GuiContext::redrawTopLevels() const noexcept
+    {
+        vector<sGuiModel> models;
+        {
+            lock_guard<mutex> guard(m_mutex);
+            models.assign(m_top_levels.begin(), m_top_levels.end());
+        }
+        for(auto model : models)
+        {
+            for(auto view : model->getViews())
+            {
+                view->invalidate();
+            }
+        }
+    }
+    
     void GuiContext::addTopLevelModel(sGuiModel view) noexcept
     {
         if(view)
@@ -101,6 +349,62 @@ namespace Kiwi
             m_top_levels.erase(view);
         }
     }
+    
+    void GuiContext::startBlinking(sBlinkable item) noexcept
+    {
+        if(item)
+        {
+            m_blinker->add(item);
+        }
+    }
+    
+    void GuiContext::stopBlinking(sBlinkable item) noexcept
+    {
+        if(item)
+        {
+            m_blinker->remove(item);
+        }
+    }
+    
+    void GuiContext::setFrameRate(const double fps) noexcept
+    {
+        m_scheduler->setPeriod(1000. / clip(fps, 1., 1000.));
+    }
+    
+    double GuiContext::getFrameRate() const noexcept
+    {
+        return 1000. / m_scheduler->getPeriod();
+    }
+    
+    ulong GuiContext::requestAnimationFrame(FrameCallback callback) noexcept
+    {
+        if(callback)
+        {
+            return m_scheduler->request(callback);
+        }
+        return 0ul;
+    }
+    
+    void GuiContext::cancelAnimationFrame(const ulong request) noexcept
+    {
+        m_scheduler->cancel(request);
+    }
+    
+    void GuiContext::scheduleRedraw(sGuiView view, Rectangle const& area) noexcept
+    {
+        if(view && area.width() > 0. && area.height() > 0.)
+        {
+            m_scheduler->redraw(view, area);
+        }
+    }
+    
+    void GuiContext::scheduleLayout(sGuiView view, const bool moved, const bool resized) noexcept
+    {
+        if(view && (moved || resized))
+        {
+            m_scheduler->layout(view, moved, resized);
+        }
+    }
 }
 
 
@@ -24,7 +24,7 @@
 #ifndef __DEF_KIWI_GUI_CONTEXT__
 #define __DEF_KIWI_GUI_CONTEXT__
 
-#include "KiwiGuiView.h"
+#include "KiwiGuiTheme.h"
 
 namespace Kiwi
 {
@@ -34,10 +34,25 @@ namespace Kiwi
     
     class GuiContext
     {
+    public:
+        class Blinkable;
+        typedef shared_ptr<Blinkable>   sBlinkable;
+        typedef weak_ptr<Blinkable>     wBlinkable;
+        typedef function<void(const double)> FrameCallback;
+        
     private:
+        class Blinker;
+        class Scheduler;
+        
         const wGuiDeviceManager m_device;
         set<sGuiModel>          m_top_levels;
-        mutex                   m_mutex;
+        mutable mutex           m_mutex;
+        GuiTheme                m_theme;
+        const shared_ptr<Blinker> m_blinker;
+        const shared_ptr<Scheduler> m_scheduler;
+        
+        //! @internal
+        void redrawTopLevels() const noexcept;
         
     public:
         //! The constructor.
@@ -60,6 +75,39 @@ namespace Kiwi
             return m_device.lock();
         }
         
+        //! Retrieves the theme.
+        /** The function retrieves the theme of the context.
+         @return The theme.
+         */
+        inline GuiTheme const& getTheme() const noexcept
+        {
+            return m_theme;
+        }
+        
+        //! Retrieves a color of the theme.
+        /** The function retrieves a precomputed color of the theme of the context.
+         @param role    The role of the color.
+         @param variant The variant of the color.
+         @return The color.
+         */
+        inline Color getThemeColor(const GuiTheme::Role role, const GuiTheme::Variant variant = GuiTheme::Normal) const noexcept
+        {
+            return m_theme.getColor(role, variant);
+        }
+        
+        //! Sets the theme.
+        /** The function sets the theme of the context and redraws all the top level views.
+         @param theme The theme.
+         */
+        void setTheme(GuiTheme const& theme) noexcept;
+        
+        //! Sets a color of the theme.
+        /** The function sets a color of the theme of the context and redraws all the top level views.
+         @param role    The role of the color.
+         @param color   The color.
+         */
+        void setThemeColor(const GuiTheme::Role role, Color const& color) noexcept;
+        
         //! Create a view.
         /** The function creates a view for a controller.
          @param ctrl The controller linked with the view.
@@ -91,6 +139,80 @@ namespace Kiwi
          @param window The view of the top level window.
          */
         void removeTopLevelModel(sGuiModel window) noexcept;
+        
+        //! Starts the blinking of an object.
+        /** The function adds an object to the objects that blink. All the objects blink in phase on one timer shared by the context, the timer only runs while there are objects that blink. The phase restarts visible so a caret is shown as soon as it gets the focus.
+         @param item The object.
+         */
+        void startBlinking(sBlinkable item) noexcept;
+        
+        //! Stops the blinking of an object.
+        /** The function removes an object from the objects that blink, the timer stops with the last one.
+         @param item The object.
+         */
+        void stopBlinking(sBlinkable item) noexcept;
+        
+        //! Sets the maximum frame rate.
+        /** The function sets the maximum number of frames per second, the redraws, the layouts and the animation callbacks requested during a frame are delivered together at the next one.
+         @param fps The number of frames per second.
+         */
+        void setFrameRate(const double fps) noexcept;
+        
+        //! Retrieves the maximum frame rate.
+        /** The function retrieves the maximum number of frames per second.
+         @return The number of frames per second.
+         */
+        double getFrameRate() const noexcept;
+        
+        //! Requests a callback at the next frame.
+        /** The function requests a function to be called once at the next frame, before the layouts and the redraws. An animation should request the next frame from the callback.
+         @param callback The function that receives the time of the frame in milliseconds.
+         @return The identifier of the request.
+         */
+        ulong requestAnimationFrame(FrameCallback callback) noexcept;
+        
+        //! Cancels a callback requested for the next frame.
+        /** The function cancels a callback that hasn't been called yet.
+         @param request The identifier of the request.
+         */
+        void cancelAnimationFrame(const ulong request) noexcept;
+        
+        //! Schedules the redraw of an area of a top-level view.
+        /** The function adds an area to the region of the view that will be redrawn at the next frame.
+         @param view The top-level view.
+         @param area The area relative to the view.
+         */
+        void scheduleRedraw(sGuiView view, Rectangle const& area) noexcept;
+        
+        //! Schedules the notification of the new bounds of a view.
+        /** The function schedules the notification of the position and the size of a view at the next frame, the changes of the same frame are merged in one notification.
+         @param view    The view.
+         @param moved   true if the position of the view changed.
+         @param resized true if the size of the view changed.
+         */
+        void scheduleLayout(sGuiView view, const bool moved, const bool resized) noexcept;
+    };
+    
+    // ================================================================================ //
+    //                                  GUI BLINKABLE                                   //
+    // ================================================================================ //
+    
+    //! The blinkable.
+    /** The blinkable is the interface of the objects that blink with the timer of the context like the carets.
+     */
+    class GuiContext::Blinkable
+    {
+    public:
+        //! Destructor.
+        /** The function does nothing.
+         */
+        virtual ~Blinkable() noexcept {}
+        
+        //! Receives the phase of the blinking.
+        /** The function receives the notification that the object should be shown or hidden, the object should only redraw its own area.
+         @param visible true if the object should be shown, otherwise false.
+         */
+        virtual void blink(const bool visible) noexcept = 0;
     };
 }
 
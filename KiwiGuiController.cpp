@@ -125,28 +125,34 @@ namespace Kiwi
         {
             m_bounds = newBounds;
             
+            // Only the areas uncovered and covered by the controller are repainted in the parent.
+            sGuiController parent(getParent());
+            if(parent)
+            {
+                parent->redraw(oldBounds);
+                parent->redraw(newBounds);
+            }
+            
             sGuiView view = getView();
             if(view)
             {
-                if(!resized)
+                if(moved)
                 {
                     this->moved();
-                    view->positionChanged();
                 }
-                else if(!moved)
+                if(resized)
                 {
                     this->resized();
-                    view->sizeChanged();
                 }
-                else
+                
+                // The view is notified once per frame whatever the number of changes.
+                sGuiContext ctxt = getContext();
+                if(ctxt)
                 {
-                    this->moved();
-                    this->resized();
-                    view->boundsChanged();
+                    ctxt->scheduleLayout(view, moved, resized);
                 }
             }
             
-            sGuiController parent(getParent());
             if(parent)
             {
                 parent->childBoundsChanged(shared_from_this());
@@ -265,7 +271,16 @@ namespace Kiwi
         sGuiView view = getView();
         if(view)
         {
-            view->redraw();
+            view->invalidate();
+        }
+    }
+    
+    void GuiController::redraw(Rectangle const& area) noexcept
+    {
+        sGuiView view = getView();
+        if(view)
+        {
+            view->invalidate(area);
         }
     }
     
@@ -357,6 +357,12 @@ namespace Kiwi
          */
         void redraw() noexcept;
         
+        //! Send a notification to the view that a part of the controller needs to be redrawn.
+        /** The function sends a notification to the view that an area of the controller should be redrawn.
+         @param area The area relative to the controller.
+         */
+        void redraw(Rectangle const& area) noexcept;
+        
         //! Send a notification to the view that the controller wants the keyboard focus.
         /** The function sends a notification to the view that the controller wants the keyboard focus.
          */
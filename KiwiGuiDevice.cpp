@@ -22,26 +22,188 @@
 */
 
 #include "KiwiGuiDevice.h"
+#include <cstdio>
+#include <fstream>
+#include <sys/stat.h>
+#include <dirent.h>
 
 namespace Kiwi
 {
     // ================================================================================ //
     //                                      GUI DEVICE                                  //
     // ================================================================================ //
+    
+    static const string fontCacheHeader("kiwi-font-cache 2");
+    static const string fontCacheFooter("end");
+    
+    // Appends the modification time of a directory and of its subdirectories, installing a font in a subdirectory
+    // only modifies the subdirectory. The symbolic links aren't followed to avoid the cycles.
+    static void getModificationTimes(string const& directory, vector<pair<string, long long>>& times) noexcept
+    {
+        struct stat infos;
+        if(lstat(directory.c_str(), &infos) != 0 || !S_ISDIR(infos.st_mode))
+        {
+            times.push_back(make_pair(directory, -1ll));
+            return;
+        }
+        times.push_back(make_pair(directory, (long long)infos.st_mtime));
+        
+        vector<string> subdirectories;
+        DIR* dir = opendir(directory.c_str());
+        if(dir)
+        {
+            while(struct dirent* entry = readdir(dir))
+            {
+                const string name(entry->d_name);
+                if(name != "." && name != "..")
+                {
+                    const string path = directory + "/" + name;
+                    if(lstat(path.c_str(), &infos) == 0 && S_ISDIR(infos.st_mode))
+                    {
+                        subdirectories.push_back(path);
+                    }
+                }
+            }
+            closedir(dir);
+        }
+        
+        // The order of the entries isn't specified so the subdirectories are sorted to compare the keys.
+        sort(subdirectories.begin(), subdirectories.end());
+        for(auto subdirectory : subdirectories)
+        {
+            getModificationTimes(subdirectory, times);
+        }
+    }
+    
+    static vector<pair<string, long long>> getModificationTimes(vector<string> const& directories) noexcept
+    {
+        vector<pair<string, long long>> times;
+        for(auto directory : directories)
+        {
+            getModificationTimes(directory, times);
+        }
+        return times;
+    }
+    
+    static bool readFontCache(string const& path, vector<pair<string, long long>> const& times, vector<string>& names) noexcept
+    {
+        ifstream file(path);
+        string line;
+        if(!file || !getline(file, line) || line != fontCacheHeader)
+        {
+            return false;
+        }
+        
+        ulong ndirectories = 0;
+        if(!(file >> ndirectories) || ndirectories != times.size())
+        {
+            return false;
+        }
+        for(ulong i = 0; i < ndirectories; i++)
+        {
+            long long time;
+            if(!(file >> time) || file.get() != ' ' || !getline(file, line) || line != times[i].first || time != times[i].second)
+            {
+                return false;
+            }
+        }
+        
+        // The number of names and the end marker reject a truncated file.
+        ulong nnames = 0;
+        if(!(file >> nnames) || file.get() != '\n')
+        {
+            return false;
+        }
+        vector<string> cached;
+        cached.reserve(nnames);
+        for(ulong i = 0; i < nnames; i++)
+        {
+            if(!getline(file, line))
+            {
+                return false;
+            }
+            cached.push_back(line);
+        }
+        if(!getline(file, line) || line != fontCacheFooter)
+        {
+            return false;
+        }
+        names.insert(names.end(), cached.begin(), cached.end());
+        return true;
+    }
+    
+    static void writeFontCache(string const& path, vector<pair<string, long long>> const& times, vector<string> const& names) noexcept
+    {
+        // The cache is written in a temporary file renamed over the previous one, so a concurrent reader or an
+        // interrupted write never leaves a partial cache.
+        const string temporary = path + ".tmp";
+        {
+            ofstream file(temporary, ios::trunc);
+            if(!file)
+            {
+                return;
+            }
+            file << fontCacheHeader << "\n" << times.size() << "\n";
+            for(auto time : times)
+            {
+                file << time.second << " " << time.first << "\n";
+            }
+            file << names.size() << "\n";
+            for(auto name : names)
+            {
+                file << name << "\n";
+            }
+            file << fontCacheFooter << "\n";
+            file.close();
+            if(!file)
+            {
+                remove(temporary.c_str());
+                return;
+            }
+        }
+        if(rename(temporary.c_str(), path.c_str()) != 0)
+        {
+            // Some systems don't rename over an existing file.
+            remove(path.c_str());
+            if(rename(temporary.c_str(), path.c_str()) != 0)
+            {
+                remove(temporary.c_str());
+            }
+        }
+    }
+    
+    GuiDeviceManager::~GuiDeviceManager() noexcept
+    {
+        Font::setResolver(vector<string>(), Font::Resolver());
+    }
+    
+    void GuiDeviceManager::initialize() const noexcept
+    {
+        vector<string> names;
+        const string path = getFontCachePath();
+        const vector<string> directories = getSystemFontDirectories();
+        if(!path.empty() && !directories.empty())
+        {
+            const vector<pair<string, long long>> times = getModificationTimes(directories);
+            if(!readFontCache(path, times, names))
+            {
+                names = getSystemFontNames();
+                writeFontCache(path, times, names);
+            }
+        }
+        else
+        {
+            names = getSystemFontNames();
+        }
+        
+        // The resolver is stored globally and called by the fonts without any lock, so it only keeps a weak handle
+        // on the device manager and doesn't resolve anything once the device manager is released.
+        wcGuiDeviceManager device = shared_from_this();
+        Font::setResolver(names, [device](string const& name)
+        {
+            scGuiDeviceManager manager = device.lock();
+            return manager ? manager->createSystemFont(name) : unique_ptr<Font::Intern>();
+        });
+        Font::setDefaultFont(getSystemDefaultFont());
+    }
 }
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
@@ -32,7 +32,7 @@ namespace Kiwi
     /**
      The gui device manager
      */
-    class GuiDeviceManager
+    class GuiDeviceManager : public enable_shared_from_this<GuiDeviceManager>
     {
 	public:
 		
@@ -42,15 +42,14 @@ namespace Kiwi
         constexpr inline GuiDeviceManager() noexcept {}
 		
 		//! The destructor.
-        /** The function does nothing.
+        /** The function detaches the device manager from the font resolution.
          */
-        inline virtual ~GuiDeviceManager() noexcept {}
+        virtual ~GuiDeviceManager() noexcept;
         
-        void initialize() const noexcept
-        {
-            Font::setAvailableFonts(getSystemFonts());
-            Font::setDefaultFont(getSystemDefaultFont());
-        }
+        //! Initializes the device manager.
+        /** The function registers the names of the system's fonts and the default font. The fonts themselves are only created the first time they are requested. If the device manager provides a cache path and the font directories, the names are read from the cache file as long as the directories and their subdirectories haven't been modified since it was written. The device manager must be owned by a shared pointer.
+         */
+        void initialize() const noexcept;
         
         //! Create a view.
         /** The function creates a view for a controller.
@@ -74,11 +73,36 @@ namespace Kiwi
         
     private:
         
-        //! Retrieves all the fonts from the system.
-        /** The function retrieves all the fonts from the system.
-         @return A vector of fonts.
+        //! Retrieves the names of the fonts of the system.
+        /** The function retrieves the names of the fonts of the system. The function should not load the fonts.
+         @return A vector of font names.
+         */
+        virtual vector<string> getSystemFontNames() const noexcept = 0;
+        
+        //! Creates a font of the system.
+        /** The function creates the internal font of a font of the system the first time it is requested.
+         @param name The name of the font.
+         @return The internal font or a null pointer if the font doesn't exist.
+         */
+        virtual unique_ptr<Font::Intern> createSystemFont(string const& name) const noexcept = 0;
+        
+        //! Retrieves the font directories of the system.
+        /** The function retrieves the directories where the fonts of the system are installed. Their modification times validate the font cache file.
+         @return A vector of paths.
          */
-        virtual vector<Kiwi::Font> getSystemFonts() const noexcept = 0;
+        virtual vector<string> getSystemFontDirectories() const noexcept
+        {
+            return vector<string>();
+        }
+        
+        //! Retrieves the path of the font cache file.
+        /** The function retrieves the path of the file where the names of the fonts of the system are cached. An empty path disables the cache.
+         @return The path of the file.
+         */
+        virtual string getFontCachePath() const noexcept
+        {
+            return string();
+        }
         
         //! Retrieves the default system's font.
         /** The function retrieves the default system's font.
@@ -155,8 +155,40 @@ namespace Kiwi
         virtual void internalDrawText(wstring const& text, double x, double y, double w, double h, Font const& font,
                                       Font::Justification j, bool truncated) const noexcept
         {
-            wstring_convert<codecvt_utf8<wchar_t>> cv;
-            internalDrawText(cv.to_bytes(text), x, y, w, h, m_font, j, truncated);
+            internalDrawText(Utf8View::fromWide(text), x, y, w, h, font, j, truncated);
+        }
+        
+        //! Draws a text run within a rectangle.
+        /** The function draws a text that has already been laid out within a rectangle. The default implementation draws the lines of the run one by one at their offsets, so the text is wrapped like it has been measured. The implementations can override it to draw the run at once.
+         @param run The text run.
+         @param x The abscissa of the rectangle.
+         @param y The ordinate of the rectangle.
+         @param w The width of the rectangle.
+         @param h The height of the rectangle.
+         @param truncated If the text should be truncated if it goes out the boundaries.
+         */
+        virtual void internalDrawText(TextRun const& run, double x, double y, double w, double h, bool truncated) const noexcept
+        {
+            const Font& font = run.getFont();
+            const double height = font.getHeight();
+            double ly = y;
+            if(run.getJustification() & Font::Bottom)
+            {
+                ly += h - run.getSize().height();
+            }
+            else if(run.getJustification() & Font::VerticallyCentred)
+            {
+                ly += (h - run.getSize().height()) * 0.5;
+            }
+            for(auto const& line : run.getLines())
+            {
+                // The truncated text skips the lines out of the rectangle.
+                if(!truncated || (ly >= y && ly + height <= y + h))
+                {
+                    internalDrawTextLine(Utf8View(run.getText()).substr(line.start, line.end - line.start), x + line.offset, ly, max(line.width, w - line.offset), height, font, Font::TopLeft, false);
+                }
+                ly += height;
+            }
         }
         
         //! Draws a line of text within a rectangle.
@@ -175,8 +207,40 @@ namespace Kiwi
         virtual void internalDrawTextLine(wstring const& text, double x, double y, double w, double h, Font const& font,
                                           Font::Justification j, bool ellipses = false) const noexcept
         {
-            wstring_convert<codecvt_utf8<wchar_t>> cv;
-            internalDrawTextLine(cv.to_bytes(text), x, y, w, h, m_font, j, ellipses);
+            internalDrawTextLine(Utf8View::fromWide(text), x, y, w, h, font, j, ellipses);
+        }
+        
+        //! Draws a line of text within a rectangle.
+        /** The function draws a line of text that refers to bytes owned by another object. The default implementation copies the bytes in a string, the implementations should override it and read the view.
+         @param text The text.
+         @param x The abscissa of the rectangle.
+         @param y The ordinate of the rectangle.
+         @param w The width of the rectangle.
+         @param h The height of the rectangle.
+         @param j The justification.
+         @param ellipses If the text should be ended with ellipses if it goes out the boundaries.
+         */
+        virtual void internalDrawTextLine(Utf8View const& text, double x, double y, double w, double h, Font const& font,
+                                          Font::Justification j, bool ellipses = false) const noexcept
+        {
+            internalDrawTextLine(text.str(), x, y, w, h, font, j, ellipses);
+        }
+        
+        //! Draws a line of text within a rectangle.
+        /** The function draws a line of wide characters that are owned by another object. The default implementation copies the characters in a wide string, the implementations should override it and read the characters.
+         @param text The address of the characters.
+         @param size The number of characters.
+         @param x The abscissa of the rectangle.
+         @param y The ordinate of the rectangle.
+         @param w The width of the rectangle.
+         @param h The height of the rectangle.
+         @param j The justification.
+         @param ellipses If the text should be ended with ellipses if it goes out the boundaries.
+         */
+        virtual void internalDrawTextLine(wchar_t const* text, const ulong size, double x, double y, double w, double h, Font const& font,
+                                          Font::Justification j, bool ellipses = false) const noexcept
+        {
+            internalDrawTextLine(wstring(text, size), x, y, w, h, font, j, ellipses);
         }
         
         //! Fill a path.
@@ -185,6 +249,16 @@ namespace Kiwi
          */
         virtual void internalFillPath(Path const& path, Color const& color) const noexcept = 0;
         
+        //! Fill a path with a gradient.
+        /** The function fills a path with a gradient. The default implementation fills the path with the middle color of the gradient, the implementations should override it and use the lookup table of the gradient.
+         @param path The path.
+         @param gradient The gradient.
+         */
+        virtual void internalFillPath(Path const& path, Gradient const& gradient) const noexcept
+        {
+            internalFillPath(path, gradient.getColorAt(0.5));
+        }
+        
         //! Draw a path.
         /** The function draws a path.
          @param path        The path to draw.
@@ -229,6 +303,12 @@ namespace Kiwi
          */
         inline Rectangle getBounds() const noexcept {return m_bounds;}
         
+        //! Retrieve the clip bounds.
+        /** The function retrieves the area that must be drawn relative to the sketch, nothing drawn outside is displayed. The default implementation returns the whole sketch, the implementations should override it to return the area that is repainted.
+         @return The clip bounds.
+         */
+        virtual Rectangle getClipBounds() const noexcept {return m_bounds.withZeroOrigin();}
+        
         //! Set the current color.
         /** The function sets the color that now will be used by the sketch.
          @param color The color.
@@ -251,7 +331,7 @@ namespace Kiwi
         /** The function retrieves the font that is currently be used by the sketch.
          @return The font.
          */
-        inline Font getFont() const noexcept {return m_font;}
+        inline Font const& getFont() const noexcept {return m_font;}
         
         //! Set the current line width.
         /** The sets the line width that now will be used by the sketch.
@@ -308,6 +388,23 @@ namespace Kiwi
             internalFillPath(m_identity ? path : path.transformed(m_matrix), color);
         }
         
+        //! Fill a path with a gradient.
+        /** The function fills a path with a gradient.
+         @param path The path.
+         @param gradient The gradient.
+         */
+        void fillPath(Path const& path, Gradient const& gradient) const noexcept
+        {
+            if(m_identity)
+            {
+                internalFillPath(path, gradient);
+            }
+            else
+            {
+                internalFillPath(path.transformed(m_matrix), gradient.transformed(m_matrix));
+            }
+        }
+        
         //! Fill a path transformed by a matrix.
         /** The function fills a path with a transformed by a matrix.
          @param path The path.
@@ -420,6 +517,17 @@ namespace Kiwi
             internalFillPath(p, color);
         }
         
+        //! Fill the sketch with a gradient.
+        /** The function fills the entire sketch with a gradient.
+         @param gradient The gradient.
+         */
+        inline void fillAll(Gradient const& gradient) noexcept
+        {
+            Path p;
+            p.addRectangle(getBounds());
+            internalFillPath(p, gradient);
+        }
+        
         //! Draws a line of text within a rectangle.
         /** The function draws a line of text within a rectangle.
          @param text The text.
@@ -430,9 +538,9 @@ namespace Kiwi
          @param j The justification.
          @param truncated If the text should be truncated if it goes out the boundaries.
          */
-        inline void drawText(string const& text, double x, double y, double w, double h, Font::Justification j, bool truncated = false) const noexcept
+        inline void drawText(Utf8View const& text, double x, double y, double w, double h, Font::Justification j, bool truncated = false) const noexcept
         {
-            internalDrawText(text, x, y, w, h, m_font, j, truncated);
+            internalDrawText(*TextRunCache::get(text, m_font, w, j), x, y, w, h, truncated);
         }
         
         //! Draws a line of text within a rectangle.
@@ -445,9 +553,9 @@ namespace Kiwi
          @param j The justification.
          @param truncated If the text should be truncated if it goes out the boundaries.
          */
-        inline void drawText(string const& text, double x, double y, double w, double h, Font const& font, Font::Justification j, bool truncated = false) const noexcept
+        inline void drawText(Utf8View const& text, double x, double y, double w, double h, Font const& font, Font::Justification j, bool truncated = false) const noexcept
         {
-            internalDrawText(text, x, y, w, h, font, j, truncated);
+            internalDrawText(*TextRunCache::get(text, font, w, j), x, y, w, h, truncated);
         }
         
         //! Draw a line of text within a rectangle.
@@ -457,9 +565,9 @@ namespace Kiwi
          @param j The justification.
          @param truncated If the text should be truncated if it goes out the boundaries.
          */
-        inline void drawText(wstring const& text, Rectangle const& rect, Font::Justification j, bool truncated = false) const
+        inline void drawText(wstring const& text, Rectangle const& rect, Font::Justification j, bool truncated = false) const noexcept
         {
-            internalDrawText(text, rect.x(), rect.y(), rect.width(), rect.height(), m_font, j, truncated);
+            internalDrawText(*TextRunCache::get(text, m_font, rect.width(), j), rect.x(), rect.y(), rect.width(), rect.height(), truncated);
         }
         
         //! Draws a line of text within a rectangle.
@@ -472,9 +580,9 @@ namespace Kiwi
          @param j The justification.
          @param truncated If the text should be truncated if it goes out the boundaries.
          */
-        inline void drawText(wstring const& text, double x, double y, double w, double h, Font::Justification j, bool truncated = false) const
+        inline void drawText(wstring const& text, double x, double y, double w, double h, Font::Justification j, bool truncated = false) const noexcept
         {
-            internalDrawText(text, x, y, w, h, m_font, j, truncated);
+            internalDrawText(*TextRunCache::get(text, m_font, w, j), x, y, w, h, truncated);
         }
         
         //! Draw a line of text within a rectangle.
@@ -484,9 +592,9 @@ namespace Kiwi
          @param j The justification.
          @param truncated If the text should be truncated if it goes out the boundaries.
          */
-        void drawText(string const& text, Rectangle const& rect, Font::Justification j, bool truncated = false) const noexcept
+        void drawText(Utf8View const& text, Rectangle const& rect, Font::Justification j, bool truncated = false) const noexcept
         {
-            internalDrawText(text, rect.x(), rect.y(), rect.width(), rect.height(), m_font, j, truncated);
+            internalDrawText(*TextRunCache::get(text, m_font, rect.width(), j), rect.x(), rect.y(), rect.width(), rect.height(), truncated);
         }
         
         //! Draws a line of text within a rectangle.
@@ -499,7 +607,7 @@ namespace Kiwi
          @param j The justification.
          @param truncated If the text should be truncated if it goes out the boundaries.
          */
-        void drawTextLine(string const& text, double x, double y, double w, double h, Font::Justification j, bool ellipses = false) const noexcept
+        void drawTextLine(Utf8View const& text, double x, double y, double w, double h, Font::Justification j, bool ellipses = false) const noexcept
         {
             internalDrawTextLine(text, x, y, w, h, m_font, j, ellipses);
         }
@@ -511,7 +619,7 @@ namespace Kiwi
          @param j The justification.
          @param truncated If the text should be truncated if it goes out the boundaries.
          */
-        void drawTextLine(string const& text, Rectangle const& rect, Font::Justification j, bool ellipses = false) const noexcept
+        void drawTextLine(Utf8View const& text, Rectangle const& rect, Font::Justification j, bool ellipses = false) const noexcept
         {
             internalDrawTextLine(text, rect.x(), rect.y(), rect.width(), rect.height(), m_font, j, ellipses);
         }
@@ -543,6 +651,22 @@ namespace Kiwi
             internalDrawTextLine(text, rect.x(), rect.y(), rect.width(), rect.height(), m_font, j, ellipses);
         }
         
+        //! Draws a line of text within a rectangle.
+        /** The function draws a line of wide characters owned by another object, like the pieces of a text buffer, without copying them.
+         @param text The address of the characters.
+         @param size The number of characters.
+         @param x The abscissa of the rectangle.
+         @param y The ordinate of the rectangle.
+         @param w The width of the rectangle.
+         @param h The height of the rectangle.
+         @param j The justification.
+         @param ellipses If the text should be ended with ellipses if it goes out the boundaries.
+         */
+        void drawTextLine(wchar_t const* text, const ulong size, double x, double y, double w, double h, Font::Justification j, bool ellipses = false) const noexcept
+        {
+            internalDrawTextLine(text, size, x, y, w, h, m_font, j, ellipses);
+        }
+        
         //! Draw a point.
         /** The function draws a point (a rectangle with a size of one)
          @param x    The abscissa of the point.
@@ -658,6 +782,27 @@ namespace Kiwi
             
             fillPath(p);
         }
+        
+        //! Fill a rectangle with a gradient, optionally rounded.
+        /** The function fills a rectangle with a gradient, optionally rounded.
+         @param rect    The rectangle to draw.
+         @param gradient The gradient.
+         @param rounded The roundness of the corners.
+         */
+        inline void fillRectangle(Rectangle const& rect, Gradient const& gradient, double rounded = 0.) const noexcept
+        {
+            Path p;
+            if(rounded > 0.)
+            {
+                p.addRectangle(rect, rounded);
+            }
+            else
+            {
+                p.addRectangle(rect);
+            }
+            
+            fillPath(p, gradient);
+        }
 
         //! Draw an ellipse.
         /** The function draws an ellipse.
@@ -159,14 +159,31 @@ namespace Kiwi
         if(view)
         {
             if(hasView(view))
-                view->redraw();
+                view->invalidate();
         }
         else
         {
             const vector<sGuiView> views(getViews());
             for(auto it : views)
             {
-                it->redraw();
+                it->invalidate();
+            }
+        }
+    }
+    
+    void GuiModel::redraw(Rectangle const& area, sGuiView view) noexcept
+    {
+        if(view)
+        {
+            if(hasView(view))
+                view->invalidate(area);
+        }
+        else
+        {
+            const vector<sGuiView> views(getViews());
+            for(auto it : views)
+            {
+                it->invalidate(area);
             }
         }
     }
@@ -143,6 +143,13 @@ namespace Kiwi
 		 */
 		void redraw(sGuiView view = sGuiView()) noexcept;
         
+        //! Send a notification to one or all views that a part of the model needs to be redrawn.
+        /** The function sends a notification to one or all views that an area of the model should be redrawn.
+         @param area The area relative to the views.
+         @param view The view that should be redrawn or nothing for all.
+         */
+        void redraw(Rectangle const& area, sGuiView view = sGuiView()) noexcept;
+        
         //! Send a notification to a view that the model needs the keyboard focus.
         /** The function sends a notification to a view that the model wants the keyboard focus. If the view is empty, the notification will be sent to the first view.
          @param view The view that should retrieve the focus.
@@ -0,0 +1,96 @@
+/*
+ ==============================================================================
+ 
+ This file is part of the KIWI library.
+ Copyright (c) 2014 Pierre Guillot & Eliott Paris.
+ 
+ Permission is granted to use this software under the terms of either:
+ a) the GPL v2 (or any later version)
+ b) the Affero GPL v3
+ 
+ Details of these licenses can be found at: www.gnu.org/licenses
+ 
+ KIWI is distributed in the hope that it will be useful, but WITHOUT ANY
+ WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ 
+ ------------------------------------------------------------------------------
+ 
+ To release a closed-source product which uses KIWI, contact : guillotpierre6@gmail.com
+ 
+ ==============================================================================
+ */
+
+#include "KiwiGuiTheme.h"
+
+namespace Kiwi
+{
+    // ================================================================================ //
+    //                                      GUI THEME                                   //
+    // ================================================================================ //
+    
+    GuiTheme::GuiTheme() noexcept : m_version(0ul)
+    {
+        shared_ptr<Palette> palette = make_shared<Palette>();
+        Palette& colors = *palette;
+        colors[Background][Normal]  = Colors::grey;
+        colors[Foreground][Normal]  = Colors::white;
+        colors[Text][Normal]        = Colors::black;
+        colors[Border][Normal]      = Colors::grey.contrasted(0.8);
+        colors[Header][Normal]      = Colors::grey.contrasted(0.8);
+        colors[Button][Normal]      = Colors::white;
+        colors[Caret][Normal]       = Colors::black;
+        colors[Selection][Normal]   = Colors::blue.withAlpha(0.2);
+        colors[Close][Normal]       = Colors::red.brighter(0.4);
+        colors[Minimize][Normal]    = Colors::yellow.brighter(0.4);
+        colors[Maximize][Normal]    = Colors::green.brighter(0.4);
+        for(ulong i = 0; i < NumberOfRoles; i++)
+        {
+            computeVariants(colors[i]);
+        }
+        m_palette = palette;
+    }
+    
+    GuiTheme::GuiTheme(GuiTheme const& other) noexcept :
+    m_palette(other.getPalette()),
+    m_version(other.getVersion())
+    {
+        ;
+    }
+    
+    void GuiTheme::computeVariants(array<Color, NumberOfVariants>& colors) noexcept
+    {
+        Color const& color  = colors[Normal];
+        colors[Hover]       = color.brighter(0.1);
+        colors[Pressed]     = color.darker(0.1);
+        colors[Disabled]    = Color::withHSLA(color.hue(), color.saturation() * 0.3, color.lightness(), color.alpha() * 0.5);
+        colors[Contrast]    = (color.luminance() < 0.5) ? Colors::black : Colors::white;
+    }
+    
+    void GuiTheme::setColor(const Role role, Color const& color) noexcept
+    {
+        // Only the writers are serialized, the readers keep the palette they loaded.
+        lock_guard<mutex> guard(m_mutex);
+        const scPalette current = getPalette();
+        if(role < NumberOfRoles && (*current)[role][Normal] != color)
+        {
+            shared_ptr<Palette> palette = make_shared<Palette>(*current);
+            (*palette)[role][Normal] = color;
+            computeVariants((*palette)[role]);
+            atomic_store(&m_palette, scPalette(palette));
+            ++m_version;
+        }
+    }
+    
+    GuiTheme& GuiTheme::operator=(GuiTheme const& other) noexcept
+    {
+        if(&other != this)
+        {
+            const scPalette palette = other.getPalette();
+            lock_guard<mutex> guard(m_mutex);
+            atomic_store(&m_palette, palette);
+            ++m_version;
+        }
+        return *this;
+    }
+}
@@ -0,0 +1,149 @@
+/*
+ ==============================================================================
+ 
+ This file is part of the KIWI library.
+ Copyright (c) 2014 Pierre Guillot & Eliott Paris.
+ 
+ Permission is granted to use this software under the terms of either:
+ a) the GPL v2 (or any later version)
+ b) the Affero GPL v3
+ 
+ Details of these licenses can be found at: www.gnu.org/licenses
+ 
+ KIWI is distributed in the hope that it will be useful, but WITHOUT ANY
+ WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ 
+ ------------------------------------------------------------------------------
+ 
+ To release a closed-source product which uses KIWI, contact : guillotpierre6@gmail.com
+ 
+ ==============================================================================
+ */
+
+#ifndef __DEF_KIWI_GUI_THEME__
+#define __DEF_KIWI_GUI_THEME__
+
+#include "KiwiGuiView.h"
+
+namespace Kiwi
+{
+    // ================================================================================ //
+    //                                      GUI THEME                                   //
+    // ================================================================================ //
+    
+    //! The theme holds the colors of the graphical user interface.
+    /** The theme associates a color to each role of the interface and precomputes its variants (hover, pressed, disabled and contrasted) when the color changes, so the widgets only retrieve the colors by index when they draw. The colors are stored in an immutable palette that is replaced when a color changes, the lookups never wait for a lock.
+     */
+    class GuiTheme
+    {
+    public:
+        
+        /** The roles of the colors.
+         */
+        enum Role : ulong
+        {
+            Background  = 0,    ///< The background of the windows.
+            Foreground  = 1,    ///< The background of the widgets.
+            Text        = 2,    ///< The text.
+            Border      = 3,    ///< The borders of the widgets.
+            Header      = 4,    ///< The headers of the windows.
+            Button      = 5,    ///< The buttons.
+            Caret       = 6,    ///< The caret of the text editors.
+            Selection   = 7,    ///< The selection of the text editors.
+            Close       = 8,    ///< The close buttons of the windows.
+            Minimize    = 9,    ///< The minimize buttons of the windows.
+            Maximize    = 10,   ///< The maximize buttons of the windows.
+            NumberOfRoles = 11
+        };
+        
+        /** The variants of the colors.
+         */
+        enum Variant : ulong
+        {
+            Normal      = 0,    ///< The color itself.
+            Hover       = 1,    ///< A brighter version of the color.
+            Pressed     = 2,    ///< A darker version of the color.
+            Disabled    = 3,    ///< A desaturated and transparent version of the color.
+            Contrast    = 4,    ///< A color readable over the color (black or white).
+            NumberOfVariants = 5
+        };
+        
+        typedef array<array<Color, NumberOfVariants>, NumberOfRoles> Palette;
+        typedef shared_ptr<const Palette> scPalette;
+        
+    private:
+        scPalette       m_palette;
+        atomic<ulong>   m_version;
+        mutex           m_mutex;
+        
+        //! @internal
+        static void computeVariants(array<Color, NumberOfVariants>& colors) noexcept;
+    public:
+        
+        //! Constructor.
+        /** The function initializes the default theme.
+         */
+        GuiTheme() noexcept;
+        
+        //! Constructor.
+        /** The function initializes a theme with another.
+         @param other The other theme.
+         */
+        GuiTheme(GuiTheme const& other) noexcept;
+        
+        //! Destructor.
+        /** The function does nothing.
+         */
+        inline ~GuiTheme() noexcept {}
+        
+        //! Retrieves a color.
+        /** The function retrieves a precomputed color of the theme, an invalid role or variant gives the default black color.
+         @param role    The role of the color.
+         @param variant The variant of the color.
+         @return The color.
+         */
+        inline Color getColor(const Role role, const Variant variant = Normal) const noexcept
+        {
+            if(role < NumberOfRoles && variant < NumberOfVariants)
+            {
+                return (*atomic_load(&m_palette))[role][variant];
+            }
+            return Color();
+        }
+        
+        //! Retrieves the palette.
+        /** The function retrieves the current palette of the theme, the palette is never modified so it can be kept to retrieve several colors.
+         @return The palette.
+         */
+        inline scPalette getPalette() const noexcept
+        {
+            return atomic_load(&m_palette);
+        }
+        
+        //! Retrieves the version of the theme.
+        /** The function retrieves a number that is incremented each time a color of the theme changes.
+         @return The version.
+         */
+        inline ulong getVersion() const noexcept
+        {
+            return m_version.load();
+        }
+        
+        //! Sets a color.
+        /** The function sets the color of a role, computes its variants and replaces the palette.
+         @param role    The role of the color.
+         @param color   The color.
+         */
+        void setColor(const Role role, Color const& color) noexcept;
+        
+        //! Sets the theme with another.
+        /** The function sets the colors of the theme with the colors of another.
+         @param other The other theme.
+         @return The theme.
+         */
+        GuiTheme& operator=(GuiTheme const& other) noexcept;
+    };
+}
+
+#endif
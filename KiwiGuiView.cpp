@@ -107,7 +107,79 @@ namespace Kiwi
         }
         return Rectangle();
     }
+    
+    Rectangle GuiView::getVisibleBounds() const noexcept
+    {
+        const Size size = getSize();
+        double left = 0., top = 0., right = size.width(), bottom = size.height();
+        Point offset = getPosition();
+        sGuiView parent = getParent();
+        while(parent)
+        {
+            const Size psize = parent->getSize();
+            left    = max(left, -offset.x());
+            top     = max(top, -offset.y());
+            right   = min(right, psize.width() - offset.x());
+            bottom  = min(bottom, psize.height() - offset.y());
+            offset += parent->getPosition();
+            parent  = parent->getParent();
+        }
+        return Rectangle::withEdges(left, top, max(left, right), max(top, bottom));
+    }
 
+    void GuiView::damage(Rectangle const& area) noexcept
+    {
+        // The damages are accumulated in the coordinates of the top-level view.
+        Point offset;
+        GuiView* top = this;
+        sGuiView parent = getParent();
+        while(parent)
+        {
+            offset += top->getPosition();
+            top     = parent.get();
+            parent  = parent->getParent();
+        }
+        const Rectangle rect = area.withPosition(area.position() + offset);
+        {
+            lock_guard<mutex> guard(top->m_damage_mutex);
+            top->m_damage.add(rect);
+        }
+        
+        // The redraws are coalesced by the context and delivered once per frame.
+        sGuiContext ctxt = getContext();
+        if(ctxt)
+        {
+            ctxt->scheduleRedraw(top->shared_from_this(), rect);
+        }
+        else
+        {
+            top->redraw(rect);
+        }
+    }
+    
+    void GuiView::invalidate() noexcept
+    {
+        damage(getVisibleBounds());
+    }
+    
+    void GuiView::invalidate(Rectangle const& area) noexcept
+    {
+        const Rectangle visible = getVisibleBounds();
+        const Rectangle clipped = area.withClippedEdges(visible.left(), visible.top(), visible.right(), visible.bottom());
+        if(clipped.width() > 0. && clipped.height() > 0.)
+        {
+            damage(clipped);
+        }
+    }
+    
+    Region GuiView::takeDamage() noexcept
+    {
+        lock_guard<mutex> guard(m_damage_mutex);
+        Region region;
+        swap(region, m_damage);
+        return region;
+    }
+    
     void GuiView::addChild(sGuiView child) noexcept
     {
         if(child)
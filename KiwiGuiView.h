@@ -40,6 +40,11 @@ namespace Kiwi
         wGuiView                m_parent_view;
         vector<sGuiView>        m_childs;
         mutable mutex           m_childs_mutex;
+        Region                  m_damage;
+        mutable mutex           m_damage_mutex;
+        
+        //! @internal Adds an area relative to the view to the damaged region of the top-level view.
+        void damage(Rectangle const& area) noexcept;
     public:
         
         //! The view constructor.
@@ -163,6 +168,12 @@ namespace Kiwi
          */
         Rectangle getParentBounds() const noexcept;
         
+        //! Retrieve the visible bounds of the view.
+        /** The function retrieves the part of the view that isn't hidden by the bounds of its parents, relative to the view. For example, it's the area of the content of a viewport that is displayed.
+         @return The visible bounds of the view.
+         */
+        Rectangle getVisibleBounds() const noexcept;
+        
         //! Adds a child view to the view.
         /** The function adds a child view that will be displayed inside the view.
          @param child The child.
@@ -233,6 +244,36 @@ namespace Kiwi
          */
         virtual void redraw() = 0;
         
+        //! Receives the notification that a part of the controller needs to be redrawn.
+        /** This function is called whenever only a part of the controller needs to be redrawn. The default implementation redraws the whole view, the implementations should override it to repaint only the area.
+         @param area The area relative to the view.
+         */
+        virtual void redraw(Rectangle const& area) {redraw();}
+        
+        //! Receives the notification that a part of the controller has been moved.
+        /** This function is called whenever the content of an area has been moved by a delta, the implementations can copy the pixels already painted and only redraw the uncovered parts. The default implementation redraws the area.
+         @param area  The area relative to the view.
+         @param delta The displacement of the content.
+         */
+        virtual void scroll(Rectangle const& area, Point const& delta) {invalidate(area);}
+        
+        //! Invalidates the view.
+        /** The function adds the visible bounds of the view to the damaged region of the top-level view, the top-level view is notified at the next frame of the context.
+         */
+        void invalidate() noexcept;
+        
+        //! Invalidates a part of the view.
+        /** The function clips an area to the visible bounds of the view and adds it to the damaged region of the top-level view, the top-level view is notified at the next frame of the context. Nothing is done if the area isn't visible.
+         @param area The area relative to the view.
+         */
+        void invalidate(Rectangle const& area) noexcept;
+        
+        //! Retrieves and clears the damaged region.
+        /** The function retrieves the region invalidated since the last call, relative to the view. Only the top-level views accumulate the damages, their implementations should call it when they paint to restrict the painting to the region.
+         @return The damaged region.
+         */
+        Region takeDamage() noexcept;
+        
         //! Receives the notification that the bounds of the controller changed.
         /** This function is called by the controller whenever its bounds changed.
          */
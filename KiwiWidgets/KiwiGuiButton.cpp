@@ -30,29 +30,33 @@ namespace Kiwi
     //                                  GUI BUTTON                                      //
     // ================================================================================ //
 	
-    GuiButton::GuiButton(sGuiContext context, Color const& color) noexcept : GuiModel(context),
-    m_background_color(color)
+    GuiButton::GuiButton(sGuiContext context, const GuiTheme::Role role) noexcept : GuiModel(context),
+    m_role(role)
     {
         ;
     }
     
-    void GuiButton::setBackgroundColor(Color const& color) noexcept
+    void GuiButton::setRole(const GuiTheme::Role role) noexcept
     {
-        if(color != m_background_color)
+        if(role != m_role)
         {
-            m_background_color = color;
+            m_role = role;
             redraw();
         }
     }
     
     void GuiButton::draw(sController ctrl, Sketch& sketch) const
     {
-        const Rectangle bounds = ctrl->getBounds().withZeroOrigin();
-        sketch.setColor(m_background_color.darker(0.1));
-        sketch.setLineWidth(1.);
-        sketch.drawRectangle(bounds);
-        sketch.setColor(m_background_color);
-        sketch.fillRectangle(bounds.reduced(0.5));
+        sGuiContext context = getContext();
+        if(context)
+        {
+            const Rectangle bounds = ctrl->getBounds().withZeroOrigin();
+            sketch.setColor(context->getThemeColor(m_role, GuiTheme::Pressed));
+            sketch.setLineWidth(1.);
+            sketch.drawRectangle(bounds);
+            sketch.setColor(context->getThemeColor(m_role));
+            sketch.fillRectangle(bounds.reduced(0.5));
+        }
     }
     
     bool GuiButton::receive(sController ctrl, MouseEvent const& event)
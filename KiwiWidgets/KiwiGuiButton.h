@@ -53,35 +53,35 @@ namespace Kiwi
         typedef weak_ptr<Controller>    wController;
         
     private:
-        Color m_background_color;
+        GuiTheme::Role m_role;
     public:
         
         //! The button constructor.
         /** The function initializes the button and defaults values.
          @param context The context.
-         @param bgcolor The button background color.
+         @param role    The role of the colors of the button in the theme.
          */
-        GuiButton(sGuiContext context, Color const& bgcolor = Colors::white) noexcept;
+        GuiButton(sGuiContext context, const GuiTheme::Role role = GuiTheme::Button) noexcept;
         
         //! The button destructor.
         /** The function frees the memory.
          */
         inline virtual ~GuiButton() noexcept {};
         
-        //! Retreives the background color of the button.
-        /** The function retreives background the color of the button.
-         @return The background color.
+        //! Retreives the role of the colors of the button.
+        /** The function retreives the role of the colors of the button in the theme of the context.
+         @return The role.
          */
-        inline Color getBackgroundColor() const noexcept {return m_background_color;}
+        inline GuiTheme::Role getRole() const noexcept {return m_role;}
         
-        //! Sets the background color of the button.
-        /** The function sets the background color of the button and notifies all the views that they should be redrawn.
-         @param color The color.
+        //! Sets the role of the colors of the button.
+        /** The function sets the role of the colors of the button in the theme of the context and notifies all the views that they should be redrawn.
+         @param role The role.
          */
-        void setBackgroundColor(Color const& color) noexcept;
+        void setRole(const GuiTheme::Role role) noexcept;
         
         //! The draw method that can be override.
-        /** The function shoulds draw some stuff in the sketch. The default implementation draws a simple square with the background color and a darker border. Another implementation can draw more differents or complex shapes.
+        /** The function shoulds draw some stuff in the sketch. The default implementation draws a simple square with the color of the role and its pressed variant for the border. Another implementation can draw more differents or complex shapes.
          @param ctrl    The controller that ask to be redraw.
          @param sketch  A sketch to draw.
          */
@@ -0,0 +1,224 @@
+/*
+ ==============================================================================
+ 
+ This file is part of the KIWI library.
+ Copyright (c) 2014 Pierre Guillot & Eliott Paris.
+ 
+ Permission is granted to use this software under the terms of either:
+ a) the GPL v2 (or any later version)
+ b) the Affero GPL v3
+ 
+ Details of these licenses can be found at: www.gnu.org/licenses
+ 
+ KIWI is distributed in the hope that it will be useful, but WITHOUT ANY
+ WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ 
+ ------------------------------------------------------------------------------
+ 
+ To release a closed-source product which uses KIWI, contact : guillotpierre6@gmail.com
+ 
+ ==============================================================================
+ */
+
+
+#include "KiwiGuiLabel.h"
+#include "KiwiGuiDevice.h"
+
+namespace Kiwi
+{
+    // ================================================================================ //
+    //                                      GUI LABEL                                   //
+    // ================================================================================ //
+    
+    GuiLabel::GuiLabel(sGuiContext context, string const& text) noexcept : GuiModel(context),
+    m_justification(Font::Justification::CentredLeft),
+    m_color(Colors::black),
+    m_text(make_shared<const string>(text)),
+    m_editable(true)
+    {
+        ;
+    }
+    
+    void GuiLabel::setText(shared_ptr<const string> const& text) noexcept
+    {
+        if(text && text != m_text && *text != *m_text)
+        {
+            m_text = text;
+            redraw();
+        }
+    }
+    
+    void GuiLabel::setFont(Font const& font) noexcept
+    {
+        if(font != m_font)
+        {
+            m_font = font;
+            if(m_editor)
+            {
+                m_editor->setFont(m_font);
+            }
+            redraw();
+        }
+    }
+    
+    void GuiLabel::setColor(Color const& color) noexcept
+    {
+        if(color != m_color)
+        {
+            m_color = color;
+            if(m_editor)
+            {
+                m_editor->setColor(m_color);
+            }
+            redraw();
+        }
+    }
+    
+    void GuiLabel::setJustification(const Font::Justification justification) noexcept
+    {
+        if(justification != m_justification)
+        {
+            m_justification = justification;
+            if(m_editor)
+            {
+                m_editor->setJustification(m_justification);
+            }
+            redraw();
+        }
+    }
+    
+    void GuiLabel::setEditable(const bool editable) noexcept
+    {
+        m_editable = editable;
+        if(!m_editable && m_editor)
+        {
+            endEdit(true);
+        }
+    }
+    
+    void GuiLabel::edit() noexcept
+    {
+        if(m_editable && !m_editor)
+        {
+            m_editor = make_shared<GuiTextEditor>(getContext());
+            m_editor->setFont(m_font);
+            m_editor->setColor(m_color);
+            m_editor->setJustification(m_justification);
+            m_editor->setKeyBehavior(GuiTextEditor::Notify, GuiTextEditor::UsedAsCharacter);
+            m_editor->setText(Utf8View::toWide(*m_text));
+            m_editor->addListener(static_pointer_cast<GuiLabel>(shared_from_this()));
+            addChild(m_editor);
+            redraw();
+            m_editor->grabFocus();
+        }
+    }
+    
+    void GuiLabel::endEdit(const bool apply) noexcept
+    {
+        if(m_editor)
+        {
+            // The editor is released first so the notifications of its removal don't end the editing twice.
+            const sGuiTextEditor editor = m_editor;
+            m_editor.reset();
+            editor->removeListener(static_pointer_cast<GuiLabel>(shared_from_this()));
+            removeChild(editor);
+            const string text = Utf8View::fromWide(editor->getText());
+            if(apply && text != *m_text)
+            {
+                m_text = make_shared<const string>(text);
+                const sGuiLabel label = static_pointer_cast<GuiLabel>(shared_from_this());
+                for(auto view : getViews())
+                {
+                    sController ctrl = static_pointer_cast<Controller>(view->getController());
+                    vector<sListener> listeners(ctrl->getListeners());
+                    for(auto it : listeners)
+                    {
+                        it->labelEdited(label);
+                    }
+                }
+            }
+            redraw();
+        }
+    }
+    
+    void GuiLabel::draw(sController ctrl, Sketch& sketch) const
+    {
+        if(!m_editor && !m_text->empty())
+        {
+            sketch.setColor(m_color);
+            sketch.setFont(m_font);
+            sketch.drawText(*m_text, ctrl->getBounds().withZeroOrigin(), m_justification, true);
+        }
+    }
+    
+    void GuiLabel::returnKeyPressed(sGuiTextEditor editor)
+    {
+        endEdit(true);
+    }
+    
+    void GuiLabel::escapeKeyPressed(sGuiTextEditor editor)
+    {
+        endEdit(false);
+    }
+    
+    void GuiLabel::focusLost(sGuiTextEditor editor)
+    {
+        endEdit(true);
+    }
+    
+    sGuiController GuiLabel::createController()
+    {
+        return make_shared<Controller>(static_pointer_cast<GuiLabel>(shared_from_this()));
+    }
+    
+    // ================================================================================ //
+    //                                  GUI LABEL CONTROLLER                            //
+    // ================================================================================ //
+    
+    GuiLabel::Controller::Controller(sGuiLabel label) noexcept :
+    GuiController(label),
+    m_label(label)
+    {
+        setBounds(Rectangle(0., 0., 100., 20.));
+        shouldReceiveMouse(true);
+        shouldReceiveKeyboard(false);
+        shouldReceiveActions(false);
+    }
+    
+    void GuiLabel::Controller::draw(sGuiView view, Sketch& sketch)
+    {
+        sGuiLabel label(getLabel());
+        if(label)
+        {
+            label->draw(static_pointer_cast<Controller>(shared_from_this()), sketch);
+        }
+    }
+    
+    bool GuiLabel::Controller::receive(sGuiView view, MouseEvent const& event)
+    {
+        sGuiLabel label(getLabel());
+        if(label && label->isEditable() && event.isDoubleClick())
+        {
+            label->edit();
+            return true;
+        }
+        return false;
+    }
+    
+    void GuiLabel::Controller::childCreated(sGuiController child) noexcept
+    {
+        if(child)
+        {
+            child->setBounds(getBounds().withZeroOrigin());
+        }
+    }
+    
+    void GuiLabel::Controller::resized() noexcept
+    {
+        for(auto child : getChilds())
+        {
+            child->setBounds(getBounds().withZeroOrigin());
+        }
+    }
+}
@@ -0,0 +1,273 @@
+/*
+ ==============================================================================
+ 
+ This file is part of the KIWI library.
+ Copyright (c) 2014 Pierre Guillot & Eliott Paris.
+ 
+ Permission is granted to use this software under the terms of either:
+ a) the GPL v2 (or any later version)
+ b) the Affero GPL v3
+ 
+ Details of these licenses can be found at: www.gnu.org/licenses
+ 
+ KIWI is distributed in the hope that it will be useful, but WITHOUT ANY
+ WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ 
+ ------------------------------------------------------------------------------
+ 
+ To release a closed-source product which uses KIWI, contact : guillotpierre6@gmail.com
+ 
+ ==============================================================================
+ */
+
+
+#ifndef __DEF_KIWI_GUI_LABEL__
+#define __DEF_KIWI_GUI_LABEL__
+
+#include "KiwiGuiTextEditor.h"
+
+namespace Kiwi
+{
+    class GuiLabel;
+    typedef shared_ptr<GuiLabel>                sGuiLabel;
+    typedef weak_ptr<GuiLabel>                  wGuiLabel;
+    typedef shared_ptr<const GuiLabel>          scGuiLabel;
+    typedef weak_ptr<const GuiLabel>            wcGuiLabel;
+    
+    // ================================================================================ //
+    //                                      GUI LABEL                                   //
+    // ================================================================================ //
+    
+    //! The label displays a text.
+    /** The label is a lightweight widget that only owns an interned font and a shared UTF-8 string, so it can be instantiated thousands of times. If the label is editable, a double click creates a text editor over the label that is removed as soon as the editing ends, so the memory of an editor is only used by the label being edited.
+     */
+    class GuiLabel : public GuiModel, public GuiTextEditor::Listener
+    {
+    public:
+        class Listener;
+        typedef shared_ptr<Listener>    sListener;
+        typedef weak_ptr<Listener>      wListener;
+        
+        class Controller;
+        typedef shared_ptr<Controller>  sController;
+        typedef weak_ptr<Controller>    wController;
+        
+    private:
+        Font                        m_font;
+        Font::Justification         m_justification;
+        Color                       m_color;
+        shared_ptr<const string>    m_text;
+        bool                        m_editable;
+        sGuiTextEditor              m_editor;
+    public:
+        
+        //! The label constructor.
+        /** The function initializes the label.
+         @param context The context.
+         @param text    The UTF-8 text.
+         */
+        GuiLabel(sGuiContext context, string const& text = string()) noexcept;
+        
+        //! The label destructor.
+        /** The function frees the memory.
+         */
+        inline virtual ~GuiLabel() noexcept {};
+        
+        //! Retrieves the text of the label.
+        /** The function retrieves the shared UTF-8 text of the label.
+         @return The text.
+         */
+        inline shared_ptr<const string> getText() const noexcept {return m_text;}
+        
+        //! Sets the text of the label.
+        /** The function sets the text of the label and redraws the label.
+         @param text The UTF-8 text.
+         */
+        inline void setText(string const& text) noexcept {setText(make_shared<const string>(text));}
+        
+        //! Sets the text of the label.
+        /** The function sets the text of the label and redraws the label, the labels with the same text can share the same string.
+         @param text The shared UTF-8 text.
+         */
+        void setText(shared_ptr<const string> const& text) noexcept;
+        
+        //! Retrieves the font of the label.
+        /** The function retrieves the font of the label.
+         @return The font.
+         */
+        inline Font getFont() const noexcept {return m_font;}
+        
+        //! Sets the font of the label.
+        /** The function sets the font of the label and redraws the label.
+         @param font The font.
+         */
+        void setFont(Font const& font) noexcept;
+        
+        //! Retrieves the color of the label.
+        /** The function retrieves the color of the text of the label.
+         @return The color.
+         */
+        inline Color getColor() const noexcept {return m_color;}
+        
+        //! Sets the color of the label.
+        /** The function sets the color of the text of the label and redraws the label.
+         @param color The color.
+         */
+        void setColor(Color const& color) noexcept;
+        
+        //! Retrieves the justification of the label.
+        /** The function retrieves the justification of the text of the label.
+         @return The justification.
+         */
+        inline Font::Justification getJustification() const noexcept {return m_justification;}
+        
+        //! Sets the justification of the label.
+        /** The function sets the justification of the text of the label and redraws the label.
+         @param justification The justification.
+         */
+        void setJustification(const Font::Justification justification) noexcept;
+        
+        //! Retrieves if the label is editable.
+        /** The function retrieves if a double click edits the label.
+         @return true if the label is editable, otherwise false.
+         */
+        inline bool isEditable() const noexcept {return m_editable;}
+        
+        //! Sets if the label is editable.
+        /** The function sets if a double click edits the label, the editing stops if the label becomes read-only.
+         @param editable true if the label is editable, otherwise false.
+         */
+        void setEditable(const bool editable) noexcept;
+        
+        //! Retrieves if the label is being edited.
+        /** The function retrieves if the label has a text editor.
+         @return true if the label is being edited, otherwise false.
+         */
+        inline bool isEditing() const noexcept {return bool(m_editor);}
+        
+        //! Starts the editing.
+        /** The function creates a text editor with the text, the font and the color of the label and adds it over the label.
+         */
+        void edit() noexcept;
+        
+        //! Stops the editing.
+        /** The function removes the text editor, the text of the editor becomes the text of the label if it should be applied.
+         @param apply true if the text should be applied, otherwise false.
+         */
+        void endEdit(const bool apply = true) noexcept;
+        
+        //! The draw method that can be override.
+        /** The function draws the text of the label, nothing is drawn while the label is being edited.
+         @param ctrl    The controller that ask to be redraw.
+         @param sketch  A sketch to draw.
+         */
+        virtual void draw(sController ctrl, Sketch& sketch) const;
+        
+        //! Create the controller.
+        /** The function creates a controller depending on the inheritance.
+         @return The controller.
+         */
+        sGuiController createController() override;
+        
+    private:
+        
+        //! Receives the notification that the return key has been pressed.
+        /** The function stops the editing and applies the text.
+         @param editor The text editor.
+         */
+        void returnKeyPressed(sGuiTextEditor editor) override;
+        
+        //! Receives the notification that the escape key has been pressed.
+        /** The function stops the editing without applying the text.
+         @param editor The text editor.
+         */
+        void escapeKeyPressed(sGuiTextEditor editor) override;
+        
+        //! Receives the notification that the text editor lost the focus.
+        /** The function stops the editing and applies the text.
+         @param editor The text editor.
+         */
+        void focusLost(sGuiTextEditor editor) override;
+    };
+    
+    // ================================================================================ //
+    //                                  GUI LABEL CONTROLLER                            //
+    // ================================================================================ //
+    
+    //! The label controller.
+    /** The label controller manages a view of a label and gives its bounds to the text editor while the label is edited.
+     */
+    class GuiLabel::Controller : public GuiController, public Broadcaster<Listener>
+    {
+    private:
+        const wGuiLabel m_label;
+    public:
+        //! The label controller constructor.
+        /** The function initialize the label controller.
+         @param label  The label to control.
+         */
+        Controller(sGuiLabel label) noexcept;
+        
+        //! The controller destructor.
+        /** The function does nothing.
+         */
+        inline ~Controller() noexcept {};
+        
+        //! Gets the label.
+        /** The function retrieves the label.
+         @return The label.
+         */
+        inline sGuiLabel getLabel() const noexcept {return m_label.lock();}
+        
+        //! The draw method that can be override.
+        /** The function shoulds draw some stuff.
+         @param view    The view that owns the controller.
+         @param sketch  The sketch to draw.
+         */
+        void draw(sGuiView view, Sketch& sketch) override;
+        
+        //! The mouse receive method.
+        /** The function starts the editing of the label on a double click.
+         @param view    The view that owns the controller.
+         @param event   The mouser event.
+         @return true if the class has done something with the event, otherwise false.
+         */
+        bool receive(sGuiView view, MouseEvent const& event) override;
+        
+        //! Receives the notification that a child has been created.
+        /** The function gives the bounds of the label to the text editor.
+         @param child The child controller.
+         */
+        void childCreated(sGuiController child) noexcept override;
+        
+        //! Receives the notification that the controller has been resized.
+        /** The function gives the bounds of the label to the text editor.
+         */
+        void resized() noexcept override;
+    };
+    
+    // ================================================================================ //
+    //                                  GUI LABEL LISTENER                              //
+    // ================================================================================ //
+    
+    //! The label listener.
+    /** The label listener is notified when the text of a label has been edited.
+     */
+    class GuiLabel::Listener
+    {
+    public:
+        //! The listener destructor.
+        /** The function frees the memory.
+         */
+        virtual ~Listener() noexcept {};
+        
+        //! Receives the notification that the text of a label has been edited.
+        /** The function receives the notification that the text of a label has been edited.
+         @param label The label.
+         */
+        virtual void labelEdited(sGuiLabel label) = 0;
+    };
+}
+
+#endif
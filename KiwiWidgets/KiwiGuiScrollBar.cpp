@@ -174,7 +174,7 @@ namespace Kiwi
                 else if(m_visible && scrollbar->getThumbDisplayTime() > 0.)
                 {
                     m_visible = false;
-                    view->redraw();
+                    redraw();
                 }
                 return false;
             }
@@ -191,7 +191,7 @@ namespace Kiwi
             m_limits[1] = lmax;
             if(m_visible)
             {
-                getView()->redraw();
+                redraw();
             }
         }
     }
@@ -0,0 +1,151 @@
+/*
+ ==============================================================================
+ 
+ This file is part of the KIWI library.
+ Copyright (c) 2014 Pierre Guillot & Eliott Paris.
+ 
+ Permission is granted to use this software under the terms of either:
+ a) the GPL v2 (or any later version)
+ b) the Affero GPL v3
+ 
+ Details of these licenses can be found at: www.gnu.org/licenses
+ 
+ KIWI is distributed in the hope that it will be useful, but WITHOUT ANY
+ WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ 
+ ------------------------------------------------------------------------------
+ 
+ To release a closed-source product which uses KIWI, contact : guillotpierre6@gmail.com
+ 
+ ==============================================================================
+ */
+
+
+#include "KiwiGuiText.h"
+
+namespace Kiwi
+{
+    // ================================================================================ //
+    //                                          TEXT                                    //
+    // ================================================================================ //
+    
+    void Text::locate(const ulong pos, ulong& line, ulong& column) const noexcept
+    {
+        column = min(pos, m_size);
+        for(line = 0ul; line + 1ul < ulong(m_lines.size()) && column > m_lines[line].size(); line++)
+        {
+            column -= m_lines[line].size() + 1ul;
+        }
+    }
+    
+    void Text::setFont(Font const& font) noexcept
+    {
+        if(font != m_font)
+        {
+            m_font = font;
+            for(auto const& line : m_lines)
+            {
+                line.m_width = -1.;
+            }
+        }
+    }
+    
+    wstring Text::getText() const noexcept
+    {
+        wstring text;
+        text.reserve(m_size);
+        for(ulong i = 0; i < ulong(m_lines.size()); i++)
+        {
+            if(i)
+            {
+                text.push_back(L'\n');
+            }
+            text.append(m_lines[i].text());
+        }
+        return text;
+    }
+    
+    void Text::clear() noexcept
+    {
+        m_lines.assign(1ul, Line());
+        m_size = 0ul;
+    }
+    
+    void Text::erase(ulong start, ulong end) noexcept
+    {
+        if(start > end)
+        {
+            swap(start, end);
+        }
+        end = min(end, m_size);
+        if(start < end)
+        {
+            ulong first, second, from, to;
+            locate(start, first, from);
+            locate(end, second, to);
+            
+            // The end of the last line is appended to the first line and the lines between are removed.
+            const wstring tail = m_lines[second].m_text.substr(to);
+            Line& line = m_lines[first];
+            line.m_text.erase(from);
+            line.m_text.append(tail);
+            line.m_width = -1.;
+            m_lines.erase(m_lines.begin() + long(first) + 1l, m_lines.begin() + long(second) + 1l);
+            m_size -= end - start;
+        }
+    }
+    
+    void Text::insert(const ulong pos, wstring const& text) noexcept
+    {
+        if(!text.empty())
+        {
+            ulong index, column;
+            locate(pos, index, column);
+            
+            // The line is cut at the position, the first part of the text ends the first part of the line and the last part
+            // of the text starts the second part of the line.
+            Line& line = m_lines[index];
+            const wstring tail = line.m_text.substr(column);
+            line.m_text.erase(column);
+            line.m_width = -1.;
+            vector<Line> lines;
+            wstring::size_type start = 0, next;
+            while((next = text.find(L'\n', start)) != wstring::npos)
+            {
+                lines.push_back(Line(text.substr(start, next - start)));
+                start = next + 1;
+            }
+            lines.push_back(Line(text.substr(start) + tail));
+            
+            line.m_text.append(lines[0].m_text);
+            m_lines.insert(m_lines.begin() + long(index) + 1l, make_move_iterator(lines.begin() + 1), make_move_iterator(lines.end()));
+            m_size += ulong(text.size());
+        }
+    }
+    
+    Size Text::getTextSize(const double limit) const noexcept
+    {
+        if(empty())
+        {
+            return Size();
+        }
+        double width = 0., height = 0.;
+        for(auto const& line : m_lines)
+        {
+            const double size = line.getWidth(m_font);
+            if(limit > 0. && size > limit)
+            {
+                const Size wrapped = m_font.getTextSize(line.text(), limit);
+                width   = max(width, wrapped.width());
+                height += wrapped.height();
+            }
+            else
+            {
+                width   = max(width, size);
+                height += m_font.getHeight();
+            }
+        }
+        return Size(width, height);
+    }
+}
@@ -0,0 +1,204 @@
+/*
+ ==============================================================================
+ 
+ This file is part of the KIWI library.
+ Copyright (c) 2014 Pierre Guillot & Eliott Paris.
+ 
+ Permission is granted to use this software under the terms of either:
+ a) the GPL v2 (or any later version)
+ b) the Affero GPL v3
+ 
+ Details of these licenses can be found at: www.gnu.org/licenses
+ 
+ KIWI is distributed in the hope that it will be useful, but WITHOUT ANY
+ WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ 
+ ------------------------------------------------------------------------------
+ 
+ To release a closed-source product which uses KIWI, contact : guillotpierre6@gmail.com
+ 
+ ==============================================================================
+ */
+
+
+#ifndef __DEF_KIWI_GUI_TEXT__
+#define __DEF_KIWI_GUI_TEXT__
+
+#include "KiwiGuiTextStyles.h"
+
+namespace Kiwi
+{
+    // ================================================================================ //
+    //                                          TEXT                                    //
+    // ================================================================================ //
+    
+    //! The text.
+    /** The text is a light document model that stores a text as a vector of lines, so a line is accessed in constant time and the width of each line is measured once and cached until the line or the font changes. The positions count the line breaks as one character between two lines. The text is intended for the labels and the comments that don't need the text editor.
+     */
+    class Text
+    {
+    public:
+        static const ulong npos = ulong(-1);
+        
+        //! A line of the text.
+        /** The line stores the characters of a line, without the line break, and caches its width.
+         */
+        class Line
+        {
+        private:
+            friend class Text;
+            wstring         m_text;
+            mutable double  m_width;
+        public:
+            inline Line() noexcept : m_width(-1.) {}
+            inline Line(wstring const& text) noexcept : m_text(text), m_width(-1.) {}
+            inline Line(wstring&& text) noexcept : m_width(-1.) {m_text.swap(text);}
+            
+            inline bool empty() const noexcept {return m_text.empty();}
+            inline ulong size() const noexcept {return ulong(m_text.size());}
+            inline wstring const& text() const noexcept {return m_text;}
+            
+            //! Retrieves the width of the line.
+            /** The function retrieves the width of the line, the width is only measured the first time.
+             @param font The font of the text.
+             @return The width.
+             */
+            inline double getWidth(Font const& font) const noexcept
+            {
+                if(m_width < 0.)
+                {
+                    m_width = font.getLineWidth(m_text);
+                }
+                return m_width;
+            }
+        };
+        
+    private:
+        Font            m_font;
+        vector<Line>    m_lines;
+        ulong           m_size;
+        
+        //! @internal
+        void locate(const ulong pos, ulong& line, ulong& column) const noexcept;
+    public:
+        
+        //! Constructor.
+        /** The function initializes an empty text.
+         */
+        inline Text() noexcept : m_lines(1ul), m_size(0ul) {}
+        
+        //! Constructor.
+        /** The function initializes a text with a character.
+         @param c The character.
+         */
+        inline Text(char c) noexcept : Text(wstring(1ul, wchar_t((unsigned char)c))) {}
+        
+        //! Constructor.
+        /** The function initializes a text with a character.
+         @param c The character.
+         */
+        inline Text(wchar_t c) noexcept : Text(wstring(1ul, c)) {}
+        
+        //! Constructor.
+        /** The function initializes a text with a UTF-8 string.
+         @param text The string.
+         */
+        inline Text(string const& text) noexcept : Text(Utf8View::toWide(text)) {}
+        
+        //! Constructor.
+        /** The function initializes a text with a wide string.
+         @param text The string.
+         */
+        inline Text(wstring const& text) noexcept : m_lines(1ul), m_size(0ul) {insert(0ul, text);}
+        
+        //! Destructor.
+        /** The function frees the lines.
+         */
+        inline ~Text() noexcept {m_lines.clear();}
+        
+        //! Retrieves if the text is empty.
+        /** The function retrieves if the text has no character.
+         @return true if the text is empty, otherwise false.
+         */
+        inline bool empty() const noexcept {return !m_size;}
+        
+        //! Retrieves the number of characters.
+        /** The function retrieves the number of characters of the text, the line breaks included.
+         @return The number of characters.
+         */
+        inline ulong size() const noexcept {return m_size;}
+        
+        //! Retrieves the number of lines.
+        /** The function retrieves the number of lines of the text, an empty text has one line.
+         @return The number of lines.
+         */
+        inline ulong getNumberOfLines() const noexcept {return ulong(m_lines.size());}
+        
+        //! Retrieves a line.
+        /** The function retrieves a line of the text.
+         @param index The index of the line.
+         @return The line.
+         */
+        inline Line const& getLine(const ulong index) const noexcept {return m_lines[index];}
+        
+        //! Retrieves the font.
+        /** The function retrieves the font used to measure the text.
+         @return The font.
+         */
+        inline Font getFont() const noexcept {return m_font;}
+        
+        //! Sets the font.
+        /** The function sets the font used to measure the text, the cached widths of the lines are discarded.
+         @param font The font.
+         */
+        void setFont(Font const& font) noexcept;
+        
+        //! Retrieves the text.
+        /** The function retrieves the lines joined with line breaks.
+         @return The text.
+         */
+        wstring getText() const noexcept;
+        
+        //! Sets the text.
+        /** The function replaces the text.
+         @param text The text.
+         */
+        inline void setText(wstring const& text) noexcept {clear(); insert(0ul, text);}
+        
+        //! Clears the text.
+        /** The function removes all the characters, the text keeps one empty line.
+         */
+        void clear() noexcept;
+        
+        //! Erases characters.
+        /** The function erases the characters between two positions, the lines of the range are joined.
+         @param start   The first position.
+         @param end     The second position.
+         */
+        void erase(ulong start, ulong end) noexcept;
+        
+        //! Inserts characters.
+        /** The function inserts a text at a position, the line of the position is split at each line break of the text.
+         @param pos     The position.
+         @param text    The text.
+         */
+        void insert(const ulong pos, wstring const& text) noexcept;
+        
+        //! Inserts characters.
+        /** The function inserts a UTF-8 text at a position.
+         @param pos     The position.
+         @param text    The text.
+         */
+        inline void insert(const ulong pos, string const& text) noexcept {insert(pos, Utf8View::toWide(text));}
+        
+        //! Retrieves the size of the text.
+        /** The function retrieves the size of the text, the lines are stacked so the width is the width of the widest line and the height is the sum of the heights of the lines. If the width limit is superior to zero, the lines wider than the limit are wrapped.
+         @param limit The width limit.
+         @return The size of the text.
+         */
+        Size getTextSize(const double limit = 0.) const noexcept;
+    };
+}
+
+#endif
@@ -0,0 +1,867 @@
+/*
+ ==============================================================================
+ 
+ This file is part of the KIWI library.
+ Copyright (c) 2014 Pierre Guillot & Eliott Paris.
+ 
+ Permission is granted to use this software under the terms of either:
+ a) the GPL v2 (or any later version)
+ b) the Affero GPL v3
+ 
+ Details of these licenses can be found at: www.gnu.org/licenses
+ 
+ KIWI is distributed in the hope that it will be useful, but WITHOUT ANY
+ WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ 
+ ------------------------------------------------------------------------------
+ 
+ To release a closed-source product which uses KIWI, contact : guillotpierre6@gmail.com
+ 
+ ==============================================================================
+ */
+
+
+#include "KiwiGuiTextBuffer.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define KIWI_TEXT_BUFFER_SSE2
+#endif
+
+namespace Kiwi
+{
+    // ================================================================================ //
+    //                                      TEXT BUFFER                                 //
+    // ================================================================================ //
+    
+    // A block is only appended, the characters referred by the pieces never change. The original text block keeps
+    // the sorted offsets of its line breaks, the line breaks of the add log blocks are counted because their pieces
+    // are never longer than a block. Nothing that a piece refers to is modified, so the pieces can be read by other
+    // threads while the buffer is edited. A block of a mapped file only knows its range of bytes, its number of
+    // characters and its number of line breaks, the characters are decoded and indexed the first time they are read.
+    struct TextBuffer::Block
+    {
+        mutable unique_ptr<wchar_t[]>   data;
+        const ulong                     capacity;
+        ulong                           size;
+        mutable vector<ulong>           breaks;
+        mutable bool                    indexed;
+        const scMappedFile              file;
+        const ulong                     start;
+        const ulong                     bytes;
+        const ulong                     nbreaks;
+        mutable once_flag               decoded;
+        
+        Block(const ulong cap) noexcept : data(new wchar_t[max(cap, 1ul)]), capacity(cap), size(0ul), indexed(false),
+        start(0ul), bytes(0ul), nbreaks(0ul) {}
+        
+        Block(scMappedFile const& f, const ulong s, const ulong b, const ulong n, const ulong l) noexcept :
+        capacity(n), size(n), indexed(false), file(f), start(s), bytes(b), nbreaks(l) {}
+        
+        wchar_t const* getData() const noexcept
+        {
+            if(file)
+            {
+                call_once(decoded, [this]()
+                {
+                    decode();
+                });
+            }
+            return data.get();
+        }
+        
+        void decode() const noexcept
+        {
+            data.reset(new wchar_t[max(size, 1ul)]);
+            char const* pos = file->getData() + start;
+            char const* end = pos + bytes;
+            ulong i = 0ul;
+            while(pos < end)
+            {
+                const char32_t code = Utf8View::decode(pos, end);
+                if(sizeof(wchar_t) == 2 && code >= 0x10000)
+                {
+                    data[i++] = wchar_t(0xD800 + ((code - 0x10000) >> 10));
+                    data[i++] = wchar_t(0xDC00 + ((code - 0x10000) & 0x3FF));
+                }
+                else
+                {
+                    data[i++] = wchar_t(code);
+                }
+            }
+            index();
+        }
+        
+        void append(wchar_t const* text, const ulong n) noexcept
+        {
+            memcpy(data.get() + size, text, n * sizeof(wchar_t));
+            size += n;
+        }
+        
+        void index() const noexcept
+        {
+            for(ulong i = 0; i < size; i++)
+            {
+                if(data[i] == L'\n')
+                {
+                    breaks.push_back(i);
+                }
+            }
+            indexed = true;
+        }
+        
+        ulong getNumberOfBreaks(const ulong offset, const ulong length) const noexcept
+        {
+            if(file && offset == 0ul && length == size)
+            {
+                return nbreaks;
+            }
+            wchar_t const* chars = getData();
+            if(indexed)
+            {
+                return ulong(lower_bound(breaks.begin(), breaks.end(), offset + length) - lower_bound(breaks.begin(), breaks.end(), offset));
+            }
+            return ulong(count(chars + offset, chars + offset + length, L'\n'));
+        }
+        
+        ulong getBreak(const ulong offset, const ulong index) const noexcept
+        {
+            wchar_t const* chars = getData();
+            if(indexed)
+            {
+                return *(lower_bound(breaks.begin(), breaks.end(), offset) + long(index));
+            }
+            ulong found = 0ul;
+            for(ulong i = offset;; i++)
+            {
+                if(chars[i] == L'\n' && found++ == index)
+                {
+                    return i;
+                }
+            }
+        }
+    };
+    
+    struct TextBuffer::Node
+    {
+        scNode                  left;
+        scNode                  right;
+        shared_ptr<const Block> block;
+        ulong                   offset;
+        ulong                   length;
+        ulong                   size;
+        ulong                   breaks;
+        ulong                   lines;
+        ulong                   pieces;
+        uint32_t                priority;
+        
+        Node(scNode const& l, scNode const& r, shared_ptr<const Block> const& b, const ulong o, const ulong n, const uint32_t p) noexcept :
+        left(l), right(r), block(b), offset(o), length(n), size(getSize(l) + n + getSize(r)),
+        breaks(b->getNumberOfBreaks(o, n)), lines(getLines(l) + breaks + getLines(r)), pieces(getPieces(l) + 1ul + getPieces(r)), priority(p) {}
+        
+        Node(scNode const& l, scNode const& r, Node const& piece) noexcept :
+        left(l), right(r), block(piece.block), offset(piece.offset), length(piece.length), size(getSize(l) + length + getSize(r)),
+        breaks(piece.breaks), lines(getLines(l) + breaks + getLines(r)), pieces(getPieces(l) + 1ul + getPieces(r)), priority(piece.priority) {}
+
+    };
+    
+    static const ulong textBufferBlockSize = 4096ul;
+    
+    TextBuffer::TextBuffer() noexcept : m_seed(0x9E3779B9u)
+    {
+        ;
+    }
+    
+    TextBuffer::TextBuffer(wstring const& text) noexcept : m_seed(0x9E3779B9u)
+    {
+        setText(text);
+    }
+    
+    TextBuffer::~TextBuffer() noexcept
+    {
+        ;
+    }
+    
+    uint32_t TextBuffer::random() noexcept
+    {
+        m_seed ^= m_seed << 13;
+        m_seed ^= m_seed >> 17;
+        m_seed ^= m_seed << 5;
+        return m_seed;
+    }
+    
+    ulong TextBuffer::getSize(scNode const& node) noexcept
+    {
+        return node ? node->size : 0ul;
+    }
+    
+    ulong TextBuffer::getLines(scNode const& node) noexcept
+    {
+        return node ? node->lines : 0ul;
+    }
+    
+    ulong TextBuffer::getPieces(scNode const& node) noexcept
+    {
+        return node ? node->pieces : 0ul;
+    }
+    
+    void TextBuffer::split(scNode const& node, const ulong pos, scNode& left, scNode& right) noexcept
+    {
+        if(!node)
+        {
+            left = right = nullptr;
+            return;
+        }
+        const ulong lsize = getSize(node->left);
+        if(pos <= lsize)
+        {
+            scNode l;
+            split(node->left, pos, left, l);
+            right = make_shared<const Node>(l, node->right, *node);
+        }
+        else if(pos >= lsize + node->length)
+        {
+            scNode r;
+            split(node->right, pos - lsize - node->length, r, right);
+            left = make_shared<const Node>(node->left, r, *node);
+        }
+        else
+        {
+            // The piece is cut in two pieces that keep the priority of the node.
+            const ulong cut = pos - lsize;
+            left  = make_shared<const Node>(node->left, nullptr, node->block, node->offset, cut, node->priority);
+            right = make_shared<const Node>(nullptr, node->right, node->block, node->offset + cut, node->length - cut, node->priority);
+        }
+    }
+    
+    TextBuffer::scNode TextBuffer::merge(scNode const& left, scNode const& right) noexcept
+    {
+        if(!left)
+        {
+            return right;
+        }
+        else if(!right)
+        {
+            return left;
+        }
+        else if(left->priority > right->priority)
+        {
+            return make_shared<const Node>(left->left, merge(left->right, right), *left);
+        }
+        else
+        {
+            return make_shared<const Node>(merge(left, right->left), right->right, *right);
+        }
+    }
+    
+    TextBuffer::scNode TextBuffer::join(scNode const& left, scNode const& right) noexcept
+    {
+        if(left && right)
+        {
+            Node const* last = left.get();
+            while(last->right)
+            {
+                last = last->right.get();
+            }
+            Node const* first = right.get();
+            while(first->left)
+            {
+                first = first->left.get();
+            }
+            
+            // Two pieces that follow each other in the same block are fused, so the characters typed one by one stay in one piece.
+            if(last->block == first->block && last->offset + last->length == first->offset)
+            {
+                scNode l, previous, next, r;
+                split(left, getSize(left) - last->length, l, previous);
+                split(right, first->length, next, r);
+                return merge(merge(l, make_shared<const Node>(nullptr, nullptr, previous->block, previous->offset, previous->length + next->length, previous->priority)), r);
+            }
+        }
+        return merge(left, right);
+    }
+    
+    TextBuffer::Node const* TextBuffer::locate(scNode const& root, ulong pos, ulong& start) noexcept
+    {
+        Node const* node = root.get();
+        start = 0ul;
+        while(node)
+        {
+            const ulong lsize = getSize(node->left);
+            if(pos < lsize)
+            {
+                node = node->left.get();
+            }
+            else if(pos < lsize + node->length)
+            {
+                start += lsize;
+                return node;
+            }
+            else
+            {
+                start += lsize + node->length;
+                pos   -= lsize + node->length;
+                node   = node->right.get();
+            }
+        }
+        return nullptr;
+    }
+    
+    void TextBuffer::visit(Node const* node, ulong pos, ulong size, function<void(wchar_t const*, ulong)> const& f) noexcept
+    {
+        if(node && size)
+        {
+            const ulong lsize = getSize(node->left);
+            if(pos < lsize)
+            {
+                const ulong n = min(size, lsize - pos);
+                visit(node->left.get(), pos, n, f);
+                pos = lsize;
+                size -= n;
+            }
+            if(size && pos < lsize + node->length)
+            {
+                const ulong n = min(size, lsize + node->length - pos);
+                f(node->block->getData() + node->offset + (pos - lsize), n);
+                pos += n;
+                size -= n;
+            }
+            if(size)
+            {
+                visit(node->right.get(), pos - lsize - node->length, size, f);
+            }
+        }
+    }
+    
+    TextBuffer::scNode TextBuffer::append(wchar_t const* text, const ulong size) noexcept
+    {
+        scNode pieces;
+        ulong done = 0ul;
+        while(done < size)
+        {
+            if(!m_block || m_block->size == m_block->capacity)
+            {
+                m_block = make_shared<Block>(max(textBufferBlockSize, size - done));
+            }
+            const ulong n = min(size - done, m_block->capacity - m_block->size);
+            const ulong offset = m_block->size;
+            m_block->append(text + done, n);
+            if(m_block->capacity > textBufferBlockSize)
+            {
+                // A large text fills its own block at once, so it can be indexed before being shared.
+                m_block->index();
+            }
+            pieces = merge(pieces, make_shared<const Node>(nullptr, nullptr, m_block, offset, n, random()));
+            done += n;
+        }
+        return pieces;
+    }
+    
+    wchar_t TextBuffer::at(const ulong pos) const noexcept
+    {
+        ulong start;
+        Node const* node = locate(m_root, pos, start);
+        return node ? node->block->getData()[node->offset + pos - start] : wchar_t(0);
+    }
+    
+    wstring TextBuffer::getText(const ulong pos, const ulong size) const noexcept
+    {
+        wstring text;
+        const ulong total = getSize(m_root);
+        if(pos < total)
+        {
+            const ulong n = min(size, total - pos);
+            text.reserve(n);
+            visit(m_root.get(), pos, n, [&text](wchar_t const* data, ulong length)
+            {
+                text.append(data, length);
+            });
+        }
+        return text;
+    }
+    
+    void TextBuffer::visit(const ulong pos, const ulong size, function<void(wchar_t const*, ulong)> const& f) const noexcept
+    {
+        const ulong total = getSize(m_root);
+        if(pos < total)
+        {
+            visit(m_root.get(), pos, min(size, total - pos), f);
+        }
+    }
+    
+    void TextBuffer::setText(wstring const& text) noexcept
+    {
+        m_root.reset();
+        m_block.reset();
+        if(!text.empty())
+        {
+            // The original text has its own block that is never extended.
+            shared_ptr<Block> block = make_shared<Block>(ulong(text.size()));
+            block->append(text.data(), ulong(text.size()));
+            block->index();
+            m_root = make_shared<const Node>(nullptr, nullptr, block, 0ul, block->size, random());
+        }
+    }
+    
+    static const ulong textBufferChunkSize = 65536ul;
+    
+    bool TextBuffer::load(string const& path) noexcept
+    {
+        const scMappedFile file = make_shared<const MappedFile>(path);
+        if(!file->isValid())
+        {
+            return false;
+        }
+        m_root.reset();
+        m_block.reset();
+        
+        // The file is cut in chunks that start on a code point. A chunk is only scanned to count its characters and
+        // its line breaks, it is decoded when one of its characters is read.
+        char const* data = file->getData();
+        const ulong total = file->getSize();
+        ulong pos = (total >= 3ul && memcmp(data, "\xEF\xBB\xBF", 3) == 0) ? 3ul : 0ul;
+        while(pos < total)
+        {
+            ulong next = min(pos + textBufferChunkSize, total);
+            while(next < total && ((unsigned char)data[next] & 0xC0) == 0x80)
+            {
+                ++next;
+            }
+            ulong characters = 0ul, breaks = 0ul;
+            char const* end = data + next;
+            for(char const* it = data + pos; it < end;)
+            {
+                if((unsigned char)*it < 0x80)
+                {
+                    breaks += (*it == '\n');
+                    ++characters;
+                    ++it;
+                }
+                else
+                {
+                    const char32_t code = Utf8View::decode(it, end);
+                    characters += (sizeof(wchar_t) == 2 && code >= 0x10000) ? 2ul : 1ul;
+                }
+            }
+            shared_ptr<const Block> block = make_shared<const Block>(file, pos, next - pos, characters, breaks);
+            m_root = merge(m_root, make_shared<const Node>(nullptr, nullptr, block, 0ul, characters, random()));
+            pos = next;
+        }
+        return true;
+    }
+    
+    void TextBuffer::clear() noexcept
+    {
+        m_root.reset();
+        m_block.reset();
+    }
+    
+    void TextBuffer::insert(const ulong pos, wchar_t const* text, const ulong size) noexcept
+    {
+        if(size)
+        {
+            const bool contiguous = m_block && m_block->size < m_block->capacity;
+            shared_ptr<const Block> block = m_block;
+            const ulong offset = block ? block->size : 0ul;
+            scNode pieces = append(text, size);
+            
+            scNode left, right;
+            split(m_root, min(pos, getSize(m_root)), left, right);
+            
+            // When the characters are typed one after the other, the last piece is extended instead of adding a new one.
+            if(contiguous && left)
+            {
+                Node const* last = left.get();
+                while(last->right)
+                {
+                    last = last->right.get();
+                }
+                if(last->block == block && last->offset + last->length == offset)
+                {
+                    const scNode whole = left;
+                    scNode first, rest, previous;
+                    split(pieces, min(size, block->capacity - offset), first, rest);
+                    split(whole, getSize(whole) - last->length, left, previous);
+                    pieces = merge(make_shared<const Node>(nullptr, nullptr, previous->block, previous->offset, previous->length + first->length, previous->priority), rest);
+                }
+            }
+            m_root = merge(merge(left, pieces), right);
+        }
+    }
+    
+    void TextBuffer::insert(const ulong pos, TextBuffer const& text) noexcept
+    {
+        if(text.m_root)
+        {
+            scNode left, right;
+            split(m_root, min(pos, getSize(m_root)), left, right);
+            m_root = join(join(left, text.m_root), right);
+        }
+    }
+    
+    TextBuffer TextBuffer::extract(const ulong pos, const ulong size) const noexcept
+    {
+        TextBuffer text;
+        const ulong total = getSize(m_root);
+        if(size && pos < total)
+        {
+            scNode left, tail, right;
+            split(m_root, pos, left, tail);
+            split(tail, min(size, total - pos), text.m_root, right);
+        }
+        return text;
+    }
+    
+    void TextBuffer::erase(const ulong pos, const ulong size) noexcept
+    {
+        const ulong total = getSize(m_root);
+        if(size && pos < total)
+        {
+            scNode left, middle, tail, right;
+            split(m_root, pos, left, tail);
+            split(tail, min(size, total - pos), middle, right);
+            m_root = merge(left, right);
+        }
+    }
+    
+    ulong TextBuffer::getNumberOfPieces() const noexcept
+    {
+        return getPieces(m_root);
+    }
+    
+    ulong TextBuffer::getMemorySize() const noexcept
+    {
+        return getPieces(m_root) * ulong(sizeof(Node));
+    }
+    
+    TextBuffer::Iterator TextBuffer::getIterator(const ulong pos) const noexcept
+    {
+        Iterator it;
+        it.m_root = m_root;
+        it.m_size = size();
+        it.m_pos  = min(pos, it.m_size);
+        it.update();
+        return it;
+    }
+    
+    ulong TextBuffer::findFirstOf(wstring const& chars, const ulong pos) const noexcept
+    {
+        for(Iterator it = getIterator(pos); !it.atEnd(); ++it)
+        {
+            if(chars.find(*it) != wstring::npos)
+            {
+                return it.getPosition();
+            }
+        }
+        return npos;
+    }
+    
+    ulong TextBuffer::findFirstNotOf(wstring const& chars, const ulong pos) const noexcept
+    {
+        for(Iterator it = getIterator(pos); !it.atEnd(); ++it)
+        {
+            if(chars.find(*it) == wstring::npos)
+            {
+                return it.getPosition();
+            }
+        }
+        return npos;
+    }
+    
+    ulong TextBuffer::findLastOf(wstring const& chars, const ulong pos) const noexcept
+    {
+        const ulong total = size();
+        if(total)
+        {
+            Iterator it = getIterator(min(pos, total - 1ul));
+            while(true)
+            {
+                if(chars.find(*it) != wstring::npos)
+                {
+                    return it.getPosition();
+                }
+                else if(it.getPosition() == 0ul)
+                {
+                    break;
+                }
+                --it;
+            }
+        }
+        return npos;
+    }
+    
+    ulong TextBuffer::findLastNotOf(wstring const& chars, const ulong pos) const noexcept
+    {
+        const ulong total = size();
+        if(total)
+        {
+            Iterator it = getIterator(min(pos, total - 1ul));
+            while(true)
+            {
+                if(chars.find(*it) == wstring::npos)
+                {
+                    return it.getPosition();
+                }
+                else if(it.getPosition() == 0ul)
+                {
+                    break;
+                }
+                --it;
+            }
+        }
+        return npos;
+    }
+    
+    // Retrieves the characters that fold to a character when the case is ignored, the character itself first and then
+    // the other ones, like 'K' and the Kelvin sign for 'k'. The inverse of the folding is computed once for the
+    // characters of the first planes with the locale of the first search.
+    static wstring getFoldingCharacters(const wchar_t folded) noexcept
+    {
+        static const unordered_map<wchar_t, wstring> foldings = []()
+        {
+            unordered_map<wchar_t, wstring> result;
+            const ulong limit = sizeof(wchar_t) == 2 ? 0x10000ul : 0x20000ul;
+            for(ulong c = 0ul; c < limit; c++)
+            {
+                const wchar_t lower = wchar_t(towlower(wint_t(c)));
+                if(lower != wchar_t(c))
+                {
+                    result[lower].push_back(wchar_t(c));
+                }
+            }
+            return result;
+        }();
+        wstring characters(1ul, folded);
+        auto it = foldings.find(folded);
+        if(it != foldings.end())
+        {
+            characters += it->second;
+        }
+        return characters;
+    }
+    
+    // Finds the first character that is one of a few characters. The characters are compared sixteen bytes at once
+    // when SSE2 is available and the remaining ones are compared one by one.
+    static ulong findCharacter(wchar_t const* data, ulong pos, const ulong size, wstring const& characters) noexcept
+    {
+#ifdef KIWI_TEXT_BUFFER_SSE2
+        const ulong step = ulong(16 / sizeof(wchar_t));
+        const ulong count = ulong(characters.size());
+        if(count <= 4ul)
+        {
+            __m128i keys[4];
+            for(ulong i = 0; i < count; i++)
+            {
+                keys[i] = sizeof(wchar_t) == 2 ? _mm_set1_epi16(short(characters[i])) : _mm_set1_epi32(int(characters[i]));
+            }
+            for(; pos + step <= size; pos += step)
+            {
+                const __m128i chars = _mm_loadu_si128(reinterpret_cast<__m128i const*>(data + pos));
+                __m128i equal = _mm_setzero_si128();
+                for(ulong i = 0; i < count; i++)
+                {
+                    equal = _mm_or_si128(equal, sizeof(wchar_t) == 2 ? _mm_cmpeq_epi16(chars, keys[i]) : _mm_cmpeq_epi32(chars, keys[i]));
+                }
+                const int mask = _mm_movemask_epi8(equal);
+                if(mask)
+                {
+                    ulong byte = 0ul;
+                    while(!(mask & (1 << byte)))
+                    {
+                        ++byte;
+                    }
+                    return pos + byte / ulong(sizeof(wchar_t));
+                }
+            }
+        }
+#endif
+        for(; pos < size; pos++)
+        {
+            if(characters.find(data[pos]) != wstring::npos)
+            {
+                return pos;
+            }
+        }
+        return size;
+    }
+    
+    static inline bool equals(const wchar_t c, const wchar_t folded, const bool sensitive) noexcept
+    {
+        return c == folded || (!sensitive && wchar_t(towlower(wint_t(c))) == folded);
+    }
+    
+    bool TextBuffer::equals(const ulong pos, wstring const& text, const bool sensitive) const noexcept
+    {
+        if(pos > size() || ulong(text.size()) > size() - pos)
+        {
+            return false;
+        }
+        Iterator it = getIterator(pos);
+        for(auto c : text)
+        {
+            if(!Kiwi::equals(*it, sensitive ? c : wchar_t(towlower(wint_t(c))), sensitive))
+            {
+                return false;
+            }
+            ++it;
+        }
+        return true;
+    }
+    
+    void TextBuffer::search(wstring const& text, const ulong pos, const ulong end, const bool sensitive, function<bool(ulong)> const& found) const noexcept
+    {
+        const ulong total = size(), length = ulong(text.size());
+        if(!length || length > total)
+        {
+            return;
+        }
+        wstring pattern(text);
+        if(!sensitive)
+        {
+            transform(pattern.begin(), pattern.end(), pattern.begin(), [](wchar_t c) {return wchar_t(towlower(wint_t(c)));});
+        }
+        const wstring first = sensitive ? wstring(1ul, pattern[0]) : getFoldingCharacters(pattern[0]);
+        
+        // The pieces are scanned for the first character, a candidate is verified in its piece when it fits in it,
+        // otherwise through an iterator. Only the pieces within the range are read. When the case is ignored, the
+        // candidates are the few characters that fold to the first character (like 'K' and the Kelvin sign for 'k').
+        const ulong last = min(end, total - length + 1ul);
+        ulong current = pos;
+        while(current < last)
+        {
+            ulong start;
+            Node const* node = locate(m_root, current, start);
+            wchar_t const* data = node->block->getData() + node->offset;
+            const ulong stop = min(node->length, last - start);
+            for(ulong i = findCharacter(data, current - start, stop, first); i < stop; i = findCharacter(data, i + 1ul, stop, first))
+            {
+                bool match = true;
+                if(i + length <= node->length)
+                {
+                    for(ulong j = 1ul; j < length && match; j++)
+                    {
+                        match = Kiwi::equals(data[i + j], pattern[j], sensitive);
+                    }
+                }
+                else
+                {
+                    match = equals(start + i, text, sensitive);
+                }
+                if(match && !found(start + i))
+                {
+                    return;
+                }
+            }
+            current = start + stop;
+        }
+    }
+    
+    ulong TextBuffer::find(wstring const& text, const ulong pos, const bool sensitive) const noexcept
+    {
+        ulong result = npos;
+        search(text, pos, npos, sensitive, [&result](const ulong match)
+        {
+            result = match;
+            return false;
+        });
+        return result;
+    }
+    
+    vector<ulong> TextBuffer::findAll(wstring const& text, const ulong pos, const ulong size, const bool sensitive) const noexcept
+    {
+        vector<ulong> matches;
+        search(text, pos, size > npos - pos ? npos : pos + size, sensitive, [&matches](const ulong match)
+        {
+            matches.push_back(match);
+            return true;
+        });
+        return matches;
+    }
+    
+    ulong TextBuffer::getLineIndex(const ulong pos) const noexcept
+    {
+        Node const* node = m_root.get();
+        ulong current = min(pos, size()), line = 0ul;
+        while(node)
+        {
+            const ulong lsize = getSize(node->left);
+            if(current < lsize)
+            {
+                node = node->left.get();
+            }
+            else if(current <= lsize + node->length)
+            {
+                return line + getLines(node->left) + node->block->getNumberOfBreaks(node->offset, current - lsize);
+            }
+            else
+            {
+                line    += getLines(node->left) + node->breaks;
+                current -= lsize + node->length;
+                node     = node->right.get();
+            }
+        }
+        return line;
+    }
+    
+    ulong TextBuffer::getLineStart(const ulong line) const noexcept
+    {
+        if(line == 0ul)
+        {
+            return 0ul;
+        }
+        else if(line > getLines(m_root))
+        {
+            return size();
+        }
+        
+        // Looks for the position after the line break that ends the previous line.
+        Node const* node = m_root.get();
+        ulong index = line - 1ul, pos = 0ul;
+        while(node)
+        {
+            const ulong llines = getLines(node->left);
+            if(index < llines)
+            {
+                node = node->left.get();
+            }
+            else if(index < llines + node->breaks)
+            {
+                const ulong offset = node->block->getBreak(node->offset, index - llines);
+                return pos + getSize(node->left) + (offset - node->offset) + 1ul;
+            }
+            else
+            {
+                index -= llines + node->breaks;
+                pos   += getSize(node->left) + node->length;
+                node   = node->right.get();
+            }
+        }
+        return size();
+    }
+    
+    ulong TextBuffer::getLineEnd(const ulong line) const noexcept
+    {
+        return line < getLines(m_root) ? getLineStart(line + 1ul) - 1ul : size();
+    }
+    
+    // ================================================================================ //
+    //                                  TEXT BUFFER ITERATOR                            //
+    // ================================================================================ //
+    
+    void TextBuffer::Iterator::update() noexcept
+    {
+        Node const* node = locate(m_root, m_pos, m_start);
+        if(node)
+        {
+            m_data   = node->block->getData() + node->offset;
+            m_length = node->length;
+        }
+        else
+        {
+            m_data   = nullptr;
+            m_start  = m_pos;
+            m_length = 0ul;
+        }
+    }
+}
@@ -0,0 +1,387 @@
+/*
+ ==============================================================================
+ 
+ This file is part of the KIWI library.
+ Copyright (c) 2014 Pierre Guillot & Eliott Paris.
+ 
+ Permission is granted to use this software under the terms of either:
+ a) the GPL v2 (or any later version)
+ b) the Affero GPL v3
+ 
+ Details of these licenses can be found at: www.gnu.org/licenses
+ 
+ KIWI is distributed in the hope that it will be useful, but WITHOUT ANY
+ WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ 
+ ------------------------------------------------------------------------------
+ 
+ To release a closed-source product which uses KIWI, contact : guillotpierre6@gmail.com
+ 
+ ==============================================================================
+ */
+
+
+#ifndef __DEF_KIWI_GUI_TEXT_BUFFER__
+#define __DEF_KIWI_GUI_TEXT_BUFFER__
+
+#include "KiwiGuiViewport.h"
+
+namespace Kiwi
+{
+    // ================================================================================ //
+    //                                      TEXT BUFFER                                 //
+    // ================================================================================ //
+    
+    //! The text buffer.
+    /** The text buffer is a piece table that stores a text as a sequence of pieces that refer to immutable blocks of characters. The original text is never modified and the inserted characters are appended to an add log, so inserting or erasing characters only changes the pieces. The pieces are stored in a persistent balanced tree (an implicit treap) so the operations are logarithmic whatever their positions, and a copy of the buffer shares the whole tree.
+     */
+    class TextBuffer
+    {
+    public:
+        static const ulong npos = ulong(-1);
+        class Iterator;
+        
+    private:
+        struct Block;
+        struct Node;
+        typedef shared_ptr<const Node> scNode;
+        
+        scNode              m_root;
+        shared_ptr<Block>   m_block;
+        uint32_t            m_seed;
+        
+        //! @internal
+        uint32_t random() noexcept;
+        
+        //! @internal
+        scNode append(wchar_t const* text, const ulong size) noexcept;
+        
+        //! @internal
+        static ulong getSize(scNode const& node) noexcept;
+        
+        //! @internal
+        static ulong getLines(scNode const& node) noexcept;
+        
+        //! @internal
+        static ulong getPieces(scNode const& node) noexcept;
+        
+        //! @internal
+        static void split(scNode const& node, const ulong pos, scNode& left, scNode& right) noexcept;
+        
+        //! @internal
+        static scNode merge(scNode const& left, scNode const& right) noexcept;
+        
+        //! @internal
+        static scNode join(scNode const& left, scNode const& right) noexcept;
+        
+        //! @internal
+        static Node const* locate(scNode const& root, ulong pos, ulong& start) noexcept;
+        
+        //! @internal
+        static void visit(Node const* node, ulong pos, ulong size, function<void(wchar_t const*, ulong)> const& f) noexcept;
+        
+        //! @internal
+        void search(wstring const& text, const ulong pos, const ulong end, const bool sensitive, function<bool(ulong)> const& found) const noexcept;
+    public:
+        
+        //! Constructor.
+        /** The function initializes an empty buffer.
+         */
+        TextBuffer() noexcept;
+        
+        //! Constructor.
+        /** The function initializes a buffer with a text.
+         @param text The text.
+         */
+        TextBuffer(wstring const& text) noexcept;
+        
+        //! Destructor.
+        /** The function does nothing.
+         */
+        ~TextBuffer() noexcept;
+        
+        //! Retrieves the number of characters.
+        /** The function retrieves the number of characters of the buffer.
+         @return The number of characters.
+         */
+        inline ulong size() const noexcept {return getSize(m_root);}
+        
+        //! Retrieves if the buffer is empty.
+        /** The function retrieves if the buffer is empty.
+         @return true if the buffer is empty, otherwise false.
+         */
+        inline bool empty() const noexcept {return !m_root;}
+        
+        //! Retrieves a character.
+        /** The function retrieves the character at a position.
+         @param pos The position.
+         @return The character or zero if the position is out of range.
+         */
+        wchar_t at(const ulong pos) const noexcept;
+        
+        //! Retrieves a character.
+        /** The function retrieves the character at a position.
+         @param pos The position.
+         @return The character or zero if the position is out of range.
+         */
+        inline wchar_t operator[](const ulong pos) const noexcept {return at(pos);}
+        
+        //! Retrieves the text.
+        /** The function retrieves the whole text of the buffer.
+         @return The text.
+         */
+        inline wstring getText() const noexcept {return getText(0ul, npos);}
+        
+        //! Retrieves a part of the text.
+        /** The function retrieves a range of characters of the buffer.
+         @param pos     The position of the first character.
+         @param size    The number of characters.
+         @return The text.
+         */
+        wstring getText(const ulong pos, const ulong size) const noexcept;
+        
+        //! Visits a part of the text.
+        /** The function calls a function with the characters of each piece of a range of characters, in order, so the text can be read without being copied. The characters are only valid during the call.
+         @param pos     The position of the first character.
+         @param size    The number of characters.
+         @param f       The function that receives the address and the number of characters of a piece.
+         */
+        void visit(const ulong pos, const ulong size, function<void(wchar_t const*, ulong)> const& f) const noexcept;
+        
+        //! Sets the text.
+        /** The function replaces the text of the buffer, the text becomes the original text of the buffer.
+         @param text The text.
+         */
+        void setText(wstring const& text) noexcept;
+        
+        //! Loads a file.
+        /** The function replaces the text of the buffer by the content of a UTF-8 file. The file is mapped in memory and cut in chunks whose characters and line breaks are counted without being stored, a chunk is only decoded when its characters are read, so the memory used is proportional to the part of the text that has been displayed or edited.
+         @param path The path of the file.
+         @return true if the file has been mapped, otherwise false.
+         */
+        bool load(string const& path) noexcept;
+        
+        //! Clears the text.
+        /** The function clears the text of the buffer.
+         */
+        void clear() noexcept;
+        
+        //! Inserts characters.
+        /** The function inserts characters at a position.
+         @param pos     The position.
+         @param text    The characters.
+         @param size    The number of characters.
+         */
+        void insert(const ulong pos, wchar_t const* text, const ulong size) noexcept;
+        
+        //! Inserts a text.
+        /** The function inserts a text at a position.
+         @param pos     The position.
+         @param text    The text.
+         */
+        inline void insert(const ulong pos, wstring const& text) noexcept {insert(pos, text.data(), ulong(text.size()));}
+        
+        //! Inserts the content of another buffer.
+        /** The function inserts the pieces of another buffer at a position, the characters aren't copied. The pieces that follow each other in the same block are fused.
+         @param pos     The position.
+         @param text    The buffer to insert.
+         */
+        void insert(const ulong pos, TextBuffer const& text) noexcept;
+        
+        //! Extracts a range of characters.
+        /** The function retrieves a buffer that shares the pieces of a range of characters, the characters aren't copied.
+         @param pos     The position of the first character.
+         @param size    The number of characters.
+         @return The buffer.
+         */
+        TextBuffer extract(const ulong pos, const ulong size) const noexcept;
+        
+        //! Erases characters.
+        /** The function erases a range of characters.
+         @param pos     The position of the first character.
+         @param size    The number of characters.
+         */
+        void erase(const ulong pos, const ulong size) noexcept;
+        
+        //! Retrieves the number of lines.
+        /** The function retrieves the number of lines of the buffer, that is the number of line breaks plus one.
+         @return The number of lines.
+         */
+        inline ulong getNumberOfLines() const noexcept {return getLines(m_root) + 1ul;}
+        
+        //! Retrieves the line of a position.
+        /** The function retrieves the index of the line that contains a position. The line breaks are counted in the tree of the buffer so the function is logarithmic.
+         @param pos The position.
+         @return The index of the line.
+         */
+        ulong getLineIndex(const ulong pos) const noexcept;
+        
+        //! Retrieves the start of a line.
+        /** The function retrieves the position of the first character of a line.
+         @param line The index of the line.
+         @return The position of the first character or the size of the buffer if the line doesn't exist.
+         */
+        ulong getLineStart(const ulong line) const noexcept;
+        
+        //! Retrieves the end of a line.
+        /** The function retrieves the position of the line break that ends a line or the size of the buffer for the last line.
+         @param line The index of the line.
+         @return The position of the end of the line.
+         */
+        ulong getLineEnd(const ulong line) const noexcept;
+        
+        //! Retrieves the number of pieces.
+        /** The function retrieves the number of pieces of the buffer.
+         @return The number of pieces.
+         */
+        ulong getNumberOfPieces() const noexcept;
+        
+        //! Retrieves the memory used by the pieces.
+        /** The function retrieves the memory used by the pieces of the buffer, the blocks of characters that the pieces share aren't counted.
+         @return The size in bytes.
+         */
+        ulong getMemorySize() const noexcept;
+        
+        //! Retrieves an iterator.
+        /** The function retrieves an iterator at a position.
+         @param pos The position.
+         @return The iterator.
+         */
+        Iterator getIterator(const ulong pos = 0ul) const noexcept;
+        
+        //! Finds the first occurence of a set of characters.
+        /** The function finds the first character that is one of a set of characters from a position.
+         @param chars   The set of characters.
+         @param pos     The position where to start.
+         @return The position of the character or npos.
+         */
+        ulong findFirstOf(wstring const& chars, const ulong pos = 0ul) const noexcept;
+        
+        //! Finds the first character that is not in a set of characters.
+        /** The function finds the first character that is not one of a set of characters from a position.
+         @param chars   The set of characters.
+         @param pos     The position where to start.
+         @return The position of the character or npos.
+         */
+        ulong findFirstNotOf(wstring const& chars, const ulong pos = 0ul) const noexcept;
+        
+        //! Finds the last occurence of a set of characters.
+        /** The function finds the last character that is one of a set of characters before or at a position.
+         @param chars   The set of characters.
+         @param pos     The position where to start.
+         @return The position of the character or npos.
+         */
+        ulong findLastOf(wstring const& chars, const ulong pos = npos) const noexcept;
+        
+        //! Finds the last character that is not in a set of characters.
+        /** The function finds the last character that is not one of a set of characters before or at a position.
+         @param chars   The set of characters.
+         @param pos     The position where to start.
+         @return The position of the character or npos.
+         */
+        ulong findLastNotOf(wstring const& chars, const ulong pos = npos) const noexcept;
+        
+        //! Compares a text with the characters at a position.
+        /** The function retrieves if the characters at a position are the characters of a text.
+         @param pos         The position.
+         @param text        The text.
+         @param sensitive   false if the case should be ignored.
+         @return true if the characters are the same, otherwise false.
+         */
+        bool equals(const ulong pos, wstring const& text, const bool sensitive = true) const noexcept;
+        
+        //! Finds the first occurence of a text.
+        /** The function finds the first occurence of a text from a position. The pieces are scanned for the first character of the text with a vectorized kernel and each candidate is verified, the occurences that span several pieces are found too.
+         @param text        The text.
+         @param pos         The position where to start.
+         @param sensitive   false if the case should be ignored.
+         @return The position of the occurence or npos.
+         */
+        ulong find(wstring const& text, const ulong pos = 0ul, const bool sensitive = true) const noexcept;
+        
+        //! Finds the occurences of a text in a range.
+        /** The function finds the positions of all the occurences of a text that start in a range of characters, the occurences can overlap.
+         @param text        The text.
+         @param pos         The position of the first character of the range.
+         @param size        The number of characters of the range.
+         @param sensitive   false if the case should be ignored.
+         @return The sorted positions of the occurences.
+         */
+        vector<ulong> findAll(wstring const& text, const ulong pos = 0ul, const ulong size = npos, const bool sensitive = true) const noexcept;
+    };
+    
+    //! The text buffer iterator.
+    /** The iterator moves over the characters of a text buffer, it only looks for a piece in the tree when it leaves the current one. The iterator keeps the tree of the buffer so it remains valid if the buffer is modified.
+     */
+    class TextBuffer::Iterator
+    {
+    private:
+        friend class TextBuffer;
+        
+        scNode          m_root;
+        ulong           m_size;
+        ulong           m_pos;
+        wchar_t const*  m_data;
+        ulong           m_start;
+        ulong           m_length;
+        
+        //! @internal
+        void update() noexcept;
+    public:
+        
+        //! Constructor.
+        /** The function initializes an iterator at the end of an empty buffer.
+         */
+        inline Iterator() noexcept : m_size(0ul), m_pos(0ul), m_data(nullptr), m_start(0ul), m_length(0ul) {}
+        
+        //! Retrieves the position.
+        /** The function retrieves the position of the iterator.
+         @return The position.
+         */
+        inline ulong getPosition() const noexcept {return m_pos;}
+        
+        //! Retrieves if the iterator is at the end.
+        /** The function retrieves if the iterator is after the last character.
+         @return true if the iterator is at the end, otherwise false.
+         */
+        inline bool atEnd() const noexcept {return m_pos >= m_size;}
+        
+        //! Retrieves the current character.
+        /** The function retrieves the character at the position of the iterator.
+         @return The character or zero if the iterator is at the end.
+         */
+        inline wchar_t operator*() const noexcept
+        {
+            return (m_pos >= m_start && m_pos < m_start + m_length) ? m_data[m_pos - m_start] : wchar_t(0);
+        }
+        
+        //! Moves to the next character.
+        /** The function moves the iterator to the next character.
+         @return The iterator.
+         */
+        inline Iterator& operator++() noexcept
+        {
+            if(m_pos < m_size && ++m_pos >= m_start + m_length && m_pos < m_size)
+            {
+                update();
+            }
+            return *this;
+        }
+        
+        //! Moves to the previous character.
+        /** The function moves the iterator to the previous character.
+         @return The iterator.
+         */
+        inline Iterator& operator--() noexcept
+        {
+            if(m_pos > 0ul && --m_pos < m_start)
+            {
+                update();
+            }
+            return *this;
+        }
+    };
+}
+
+#endif
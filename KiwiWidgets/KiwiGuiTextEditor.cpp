@@ -35,8 +35,11 @@ namespace Kiwi
     {
         m_notify_return = UsedAsCharacter;
         m_notify_tab    = UsedAsCharacter;
-        m_redraw        = false;
+        m_version       = 0ul;
+        m_search_sensitive = true;
+        m_matches_pending  = false;
         m_line_space    = 1.;
+        m_wrapped       = false;
         m_justification = Font::Justification::TopLeft;
         m_empty_width   = m_font.getCharacterWidth(L' ');
     }
@@ -57,8 +60,11 @@ namespace Kiwi
         {
             m_font        = font;
             m_empty_width = m_font.getCharacterWidth(L' ');
+            {
+                lock_guard<mutex> guard(m_text_mutex);
+                m_layouts.clear();
+            }
             redraw();
-            m_redraw = false;
         }
     }
     
@@ -67,20 +73,38 @@ namespace Kiwi
         if(justification & Font::Justification::Left && !(m_justification & Font::Justification::Left))
         {
             m_justification = Font::Justification::TopLeft;
+            {
+                lock_guard<mutex> guard(m_text_mutex);
+                for(auto& layout : m_layouts)
+                {
+                    layout.second.setJustification(m_justification);
+                }
+            }
             redraw();
-            m_redraw = false;
         }
         else if(justification & Font::Justification::Right && !(m_justification & Font::Justification::Right))
         {
             m_justification = Font::Justification::TopRight;
+            {
+                lock_guard<mutex> guard(m_text_mutex);
+                for(auto& layout : m_layouts)
+                {
+                    layout.second.setJustification(m_justification);
+                }
+            }
             redraw();
-            m_redraw = false;
         }
         else if(justification & Font::Justification::HorizontallyCentered && !(m_justification & Font::Justification::HorizontallyCentered))
         {
             m_justification = Font::Justification::CentredTop;
+            {
+                lock_guard<mutex> guard(m_text_mutex);
+                for(auto& layout : m_layouts)
+                {
+                    layout.second.setJustification(m_justification);
+                }
+            }
             redraw();
-            m_redraw = false;
         }
     }
     
@@ -89,8 +113,14 @@ namespace Kiwi
         if(factor != m_line_space)
         {
             m_line_space = factor;
+            {
+                lock_guard<mutex> guard(m_text_mutex);
+                for(auto& layout : m_layouts)
+                {
+                    layout.second.setLineHeight(getLineHeight());
+                }
+            }
             redraw();
-            m_redraw = false;
         }
     }
     
@@ -99,8 +129,11 @@ namespace Kiwi
         if(wrap != m_wrapped)
         {
             m_wrapped = wrap;
+            {
+                lock_guard<mutex> guard(m_text_mutex);
+                m_layouts.clear();
+            }
             redraw();
-            m_redraw = false;
         }
     }
     
@@ -120,7 +153,6 @@ namespace Kiwi
         {
             m_color = color;
             redraw();
-            m_redraw = false;
         }
     }
     
@@ -131,18 +163,127 @@ namespace Kiwi
         {
             sketch.setColor(m_color);
             sketch.setFont(m_font);
-            if(!m_wrapped)
-            {
-                sketch.drawText(m_text, view->getBounds().withZeroOrigin(), m_justification, false);
-            }
-            else
+            
+            // Only the rows within the clip and the visible part of the view are drawn.
+            const Rectangle clip = sketch.getClipBounds(), visible = view->getVisibleBounds();
+            const double top = max(clip.y(), visible.y()), bottom = min(clip.bottom(), visible.bottom());
+            if(top < bottom)
             {
-                sketch.drawText(m_text, view->getBounds().withZeroOrigin(), m_justification, true);
+                struct Run
+                {
+                    ulong                   start;
+                    ulong                   size;
+                    double                  left;
+                    double                  right;
+                    TextStyles::scStyle     style;
+                };
+                
+                TextLayout& layout = getLayout(view->getSize().width());
+                const double height = getLineHeight();
+                const ulong last = layout.getRowIndex(m_text, bottom);
+                const ulong first = layout.getRowIndex(m_text, top);
+                const ulong length = ulong(m_search.size());
+                wstring characters;
+                
+                // While the occurences of the whole text are pending, only the visible rows are scanned.
+                vector<ulong> visible;
+                if(m_matches_pending)
+                {
+                    const ulong start = layout.getRow(m_text, first).start, end = layout.getRow(m_text, last).end;
+                    const ulong from = start > length ? start - length + 1ul : 0ul;
+                    visible = m_text.findAll(m_search, from, end - from, m_search_sensitive);
+                }
+                vector<ulong> const& matches = m_matches_pending ? visible : m_matches;
+                for(ulong i = first; i <= last; i++)
+                {
+                    const TextLayout::Row row = layout.getRow(m_text, i);
+                    
+                    // Only the runs of the row are visited, a run without style uses the font and the color of the editor.
+                    vector<Run> runs;
+                    m_styles.visit(row.start, row.end - row.start, [this, &layout, &row, &runs](const ulong pos, const ulong size, TextStyles::scStyle const& style)
+                    {
+                        const Run run = {pos, size,
+                            pos == row.start ? row.x : layout.getPosition(m_text, pos).x(),
+                            pos + size == row.end ? row.x + row.width : layout.getPosition(m_text, pos + size).x(), style};
+                        runs.push_back(run);
+                    });
+                    for(auto const& run : runs)
+                    {
+                        if(run.style && run.style->background.alpha() > 0.)
+                        {
+                            sketch.setColor(run.style->background);
+                            sketch.fillRectangle(run.left, row.y, run.right - run.left, height);
+                            sketch.setColor(m_color);
+                        }
+                    }
+                    
+                    if(!matches.empty())
+                    {
+                        // The occurences that start before the row can end in it.
+                        auto it = lower_bound(matches.begin(), matches.end(), row.start > length ? row.start - length + 1ul : 0ul);
+                        if(it != matches.end() && *it < row.end)
+                        {
+                            sketch.setColor(m_color.withAlpha(0.25));
+                            for(; it != matches.end() && *it < row.end; ++it)
+                            {
+                                const ulong from = max(*it, row.start), to = min(*it + length, row.end);
+                                if(from < to)
+                                {
+                                    const double x1 = from == row.start ? row.x : layout.getPosition(m_text, from).x();
+                                    const double x2 = to == row.end ? row.x + row.width : layout.getPosition(m_text, to).x();
+                                    sketch.fillRectangle(x1, row.y, x2 - x1, height);
+                                }
+                            }
+                            sketch.setColor(m_color);
+                        }
+                    }
+                    for(auto const& run : runs)
+                    {
+                        if(run.style)
+                        {
+                            sketch.setFont(layout.getFont(run.style->face));
+                            sketch.setColor(run.style->color);
+                        }
+                        // A run is drawn from its piece of the buffer, it is only gathered when it spans several pieces.
+                        wchar_t const* data = nullptr;
+                        ulong first = 0ul;
+                        characters.clear();
+                        m_text.visit(run.start, run.size, [&data, &first, &characters](wchar_t const* piece, ulong size)
+                        {
+                            if(!data)
+                            {
+                                data  = piece;
+                                first = size;
+                            }
+                            else
+                            {
+                                if(characters.empty())
+                                {
+                                    characters.assign(data, first);
+                                }
+                                characters.append(piece, size);
+                            }
+                        });
+                        if(!characters.empty())
+                        {
+                            data = characters.data();
+                        }
+                        if(data)
+                        {
+                            sketch.drawTextLine(data, run.size, run.left, row.y, run.right - run.left, height, Font::Justification::TopLeft);
+                        }
+                        if(run.style)
+                        {
+                            sketch.setFont(m_font);
+                            sketch.setColor(m_color);
+                        }
+                    }
+                }
             }
         }
     }
     
-    bool GuiTextEditor::receive(const sCaret caret, KeyboardEvent const& event)
+    bool GuiTextEditor::receive(vector<sCaret> const& carets, KeyboardEvent const& event)
     {
         const int code = event.getKeyCode();
         if(code == KeyboardEvent::Key::Escape)
@@ -172,177 +313,336 @@ namespace Kiwi
             }
             return true;
         }
+        else if(event.hasCmd() && (event.getCharacter() == L'z' || event.getCharacter() == L'Z'))
+        {
+            event.hasShift() ? redo() : undo();
+            return true;
+        }
         else if(event.getKeyCode() == KeyboardEvent::Key::Delete)
         {
-            if(caret->empty())
+            for(auto caret : carets)
             {
-                if(event.hasAlt())
-                {
-                    moveCaretToNextWord(caret, true);
-                }
-                if(event.hasCmd())
+                if(caret->empty())
                 {
-                    moveCaretToEndLine(caret, true);
-                }
-                else
-                {
-                    moveCaretToNextCharacter(caret, true);
+                    if(event.hasAlt())
+                    {
+                        moveCaretToNextWord(caret, true);
+                    }
+                    if(event.hasCmd())
+                    {
+                        moveCaretToEndLine(caret, true);
+                    }
+                    else
+                    {
+                        moveCaretToNextCharacter(caret, true);
+                    }
                 }
             }
-            eraseAtCaret(caret);
+            eraseAtCarets(carets);
             return true;
         }
         else if(event.getKeyCode() == KeyboardEvent::Key::Backspace)
         {
-            if(caret->empty())
+            for(auto caret : carets)
             {
-                if(event.hasAlt())
-                {
-                    moveCaretToPreviousWord(caret, true);
-                }
-                else if(event.hasCmd())
-                {
-                    moveCaretToStartLine(caret, true);
-                }
-                else
+                if(caret->empty())
                 {
-                    moveCaretToPreviousCharacter(caret, true);
+                    if(event.hasAlt())
+                    {
+                        moveCaretToPreviousWord(caret, true);
+                    }
+                    else if(event.hasCmd())
+                    {
+                        moveCaretToStartLine(caret, true);
+                    }
+                    else
+                    {
+                        moveCaretToPreviousCharacter(caret, true);
+                    }
                 }
             }
-            eraseAtCaret(caret);
+            eraseAtCarets(carets);
             return true;
         }
         else if(event.getKeyCode() == KeyboardEvent::Key::Return)
         {
-            insertAtCaret(caret, wstring(1ul, L'\n'));
+            insertAtCarets(carets, wstring(1ul, L'\n'));
             return true;
         }
         else if(event.getKeyCode() == KeyboardEvent::Key::Tab)
         {
-            insertAtCaret(caret, wstring(1ul, L'\t'));
+            insertAtCarets(carets, wstring(1ul, L'\t'));
             return true;
         }
         else if(event.isCharacter())
         {
-            insertAtCaret(caret, wstring(1ul, event.getCharacter()));
+            insertAtCarets(carets, wstring(1ul, event.getCharacter()));
             return true;
         }
         else
         {
-            const int direction = event.getKeyCode();
-            if(direction == KeyboardEvent::Key::Left)
             {
-                if(event.hasNoModifier())
-                {
-                    moveCaretToPreviousCharacter(caret, event.hasShift());
-                    return true;
-                }
-                else if(event.hasAlt())
-                {
-                    moveCaretToPreviousWord(caret, event.hasShift());
-                    return true;
-                }
-                else if(event.hasCmd())
-                {
-                    moveCaretToStartLine(caret, event.hasShift());
-                    return true;
-                }
+                lock_guard<mutex> guard(m_text_mutex);
+                m_history.close();
             }
-            else if(direction == KeyboardEvent::Key::Right)
+            const int direction = event.getKeyCode();
+            bool done = false;
+            for(auto caret : carets)
             {
-                if(event.hasNoModifier())
+                if(direction == KeyboardEvent::Key::Left)
                 {
-                    moveCaretToNextCharacter(caret, event.hasShift());
-                    return true;
-                }
-                else if(event.hasAlt())
-                {
-                    moveCaretToNextWord(caret, event.hasShift());
-                    return true;
+                    if(event.hasNoModifier())
+                    {
+                        moveCaretToPreviousCharacter(caret, event.hasShift());
+                        done = true;
+                    }
+                    else if(event.hasAlt())
+                    {
+                        moveCaretToPreviousWord(caret, event.hasShift());
+                        done = true;
+                    }
+                    else if(event.hasCmd())
+                    {
+                        moveCaretToStartLine(caret, event.hasShift());
+                        done = true;
+                    }
                 }
-                else if(event.hasCmd())
+                else if(direction == KeyboardEvent::Key::Right)
                 {
-                    moveCaretToEndLine(caret, event.hasShift());
-                    return true;
-                }
-            }
-            else if(direction == KeyboardEvent::Key::Up)
-            {
-                if(event.hasNoModifier())
-                {
-                    moveCaretToTopCharacter(caret, event.hasShift());
-                    return true;
+                    if(event.hasNoModifier())
+                    {
+                        moveCaretToNextCharacter(caret, event.hasShift());
+                        done = true;
+                    }
+                    else if(event.hasAlt())
+                    {
+                        moveCaretToNextWord(caret, event.hasShift());
+                        done = true;
+                    }
+                    else if(event.hasCmd())
+                    {
+                        moveCaretToEndLine(caret, event.hasShift());
+                        done = true;
+                    }
                 }
-                else if(event.hasAlt())
+                else if(direction == KeyboardEvent::Key::Up)
                 {
-                    moveCaretToStartLine(caret, event.hasShift());
-                    return true;
+                    if(event.hasNoModifier())
+                    {
+                        moveCaretToTopCharacter(caret, event.hasShift());
+                        done = true;
+                    }
+                    else if(event.hasAlt())
+                    {
+                        moveCaretToStartLine(caret, event.hasShift());
+                        done = true;
+                    }
+                    else if(event.hasCmd())
+                    {
+                        moveCaretToStart(caret, event.hasShift());
+                        done = true;
+                    }
                 }
-                else if(event.hasCmd())
+                else if(direction == KeyboardEvent::Key::Down)
                 {
-                    moveCaretToStart(caret, event.hasShift());
-                    return true;
+                    if(event.hasNoModifier())
+                    {
+                        moveCaretToBottomCharacter(caret, event.hasShift());
+                        done = true;
+                    }
+                    else if(event.hasAlt())
+                    {
+                        moveCaretToEndLine(caret, event.hasShift());
+                        done = true;
+                    }
+                    else if(event.hasCmd())
+                    {
+                        moveCaretToEnd(caret, event.hasShift());
+                        done = true;
+                    }
                 }
             }
-            else if(direction == KeyboardEvent::Key::Down)
+            return done;
+        }
+        return false;
+    }
+    
+    void GuiTextEditor::setText(wstring const& text) noexcept
+    {
+        lock_guard<mutex> guard(m_text_mutex);
+        m_text.setText(text);
+        ++m_version;
+        m_layouts.clear();
+        m_history.clear();
+        m_styles.reset(m_text.size());
+        
+        // The occurences are scanned in the visible rows when the editor is drawn and in the whole text only when requested.
+        m_matches.clear();
+        m_matches_pending = !m_search.empty();
+    }
+    
+    bool GuiTextEditor::loadFile(string const& path) noexcept
+    {
+        lock_guard<mutex> guard(m_text_mutex);
+        if(m_text.load(path))
+        {
+            ++m_version;
+            m_layouts.clear();
+            m_history.clear();
+            m_styles.reset(m_text.size());
+            
+            // Scanning the whole file would decode all its chunks, so the occurences are scanned in the visible rows
+            // when the editor is drawn and in the whole text only when requested.
+            m_matches.clear();
+            m_matches_pending = !m_search.empty();
+            return true;
+        }
+        return false;
+    }
+    
+    void GuiTextEditor::setStyle(const ulong pos, const ulong size, TextStyles::scStyle const& style) noexcept
+    {
+        map<double, Rows> rows;
+        {
+            lock_guard<mutex> guard(m_text_mutex);
+            if(!size || pos >= m_text.size())
             {
-                if(event.hasNoModifier())
-                {
-                    moveCaretToBottomCharacter(caret, event.hasShift());
-                    return true;
-                }
-                else if(event.hasAlt())
-                {
-                    moveCaretToEndLine(caret, event.hasShift());
-                    return true;
-                }
-                else if(event.hasCmd())
-                {
-                    moveCaretToEnd(caret, event.hasShift());
-                    return true;
-                }
+                return;
             }
+            m_styles.setStyle(pos, size, style);
             
+            // The lines of the styled characters are measured again with their fonts, the rows that follow them are
+            // moved if the wrapping changed.
+            const ulong first = m_text.getLineIndex(pos), last = m_text.getLineIndex(min(pos + size, m_text.size()) - 1ul);
+            for(auto& layout : m_layouts)
+            {
+                Rows range;
+                range.top       = layout.second.getLineRow(m_text, first);
+                range.previous  = layout.second.getLineRow(m_text, last + 1ul);
+                layout.second.replace(first, last - first, last - first);
+                range.current   = layout.second.getLineRow(m_text, last + 1ul);
+                rows[layout.first] = range;
+            }
         }
-        return false;
+        redrawRows(rows);
     }
     
-    void GuiTextEditor::setText(wstring const& text) noexcept
+    void GuiTextEditor::clearStyles() noexcept
     {
-        m_text = text;
+        {
+            lock_guard<mutex> guard(m_text_mutex);
+            m_styles.reset(m_text.size());
+            for(auto& layout : m_layouts)
+            {
+                layout.second.invalidate();
+            }
+        }
+        redraw();
     }
     
-    Size GuiTextEditor::getTextSize(const double limit) const noexcept
+    ulong GuiTextEditor::find(wstring const& text, const ulong pos, const bool sensitive) const noexcept
     {
         lock_guard<mutex> guard(m_text_mutex);
-        return m_font.getTextSize(m_text, limit);
+        return m_text.find(text, pos, sensitive);
     }
     
-    void GuiTextEditor::clearText() noexcept
+    void GuiTextEditor::setSearch(wstring const& text, const bool sensitive) noexcept
     {
-        m_redraw = true;
-        m_text.clear();
-        lock_guard<mutex> guard(m_lists_mutex);
-        auto it = m_lists.begin();
-        while(it != m_lists.end())
         {
-            sListener listener = (*it).lock();
-            if(listener)
+            lock_guard<mutex> guard(m_text_mutex);
+            if(text == m_search && sensitive == m_search_sensitive)
             {
-                listener->textChanged(static_pointer_cast<GuiTextEditor>(shared_from_this()));
-                ++it;
+                return;
+            }
+            
+            // While the text is typed, the occurences of the new text are among the occurences of the previous one.
+            if(!m_matches_pending && !m_search.empty() && sensitive == m_search_sensitive && text.compare(0, m_search.size(), m_search) == 0)
+            {
+                m_matches.erase(remove_if(m_matches.begin(), m_matches.end(), [this, &text, sensitive](const ulong pos)
+                {
+                    return !m_text.equals(pos, text, sensitive);
+                }), m_matches.end());
             }
             else
             {
-                it = m_lists.erase(it);
+                m_matches = m_text.findAll(text, 0ul, TextBuffer::npos, sensitive);
             }
+            m_search = text;
+            m_search_sensitive = sensitive;
+            m_matches_pending  = false;
+        }
+        redraw();
+    }
+    
+    vector<ulong> GuiTextEditor::getMatches() const noexcept
+    {
+        lock_guard<mutex> guard(m_text_mutex);
+        findPendingMatches();
+        return m_matches;
+    }
+    
+    void GuiTextEditor::findPendingMatches() const noexcept
+    {
+        if(m_matches_pending)
+        {
+            m_matches = m_text.findAll(m_search, 0ul, TextBuffer::npos, m_search_sensitive);
+            m_matches_pending = false;
         }
-        if(m_redraw)
+    }
+    
+    void GuiTextEditor::updateMatches(const ulong pos, const ulong removed, const ulong inserted) noexcept
+    {
+        const ulong length = ulong(m_search.size());
+        if(length && !m_matches_pending)
         {
-            redraw();
+            // The occurences that overlap the removed characters are scanned again with the inserted characters.
+            const ulong from = pos >= length - 1ul ? pos - length + 1ul : 0ul;
+            auto first = lower_bound(m_matches.begin(), m_matches.end(), from);
+            auto last  = lower_bound(first, m_matches.end(), pos + removed);
+            for(auto it = last; it != m_matches.end(); ++it)
+            {
+                *it = *it - removed + inserted;
+            }
+            const vector<ulong> matches = m_text.findAll(m_search, from, pos + inserted - from, m_search_sensitive);
+            m_matches.insert(m_matches.erase(first, last), matches.begin(), matches.end());
         }
     }
     
+    GuiTextEditor::scSnapshot GuiTextEditor::getSnapshot() const noexcept
+    {
+        lock_guard<mutex> guard(m_text_mutex);
+        if(!m_snapshot || m_snapshot->getVersion() != m_version)
+        {
+            m_snapshot = make_shared<const Snapshot>(m_text, m_version);
+        }
+        return m_snapshot;
+    }
+    
+    Size GuiTextEditor::getTextSize(const double limit) const noexcept
+    {
+        lock_guard<mutex> guard(m_text_mutex);
+        return getLayout(limit).getSize(m_text);
+    }
+    
+    void GuiTextEditor::clearText() noexcept
+    {
+        vector<Change> changes;
+        {
+            lock_guard<mutex> guard(m_text_mutex);
+            const Change change = {0ul, m_text, TextBuffer()};
+            changes.push_back(change);
+            m_text.clear();
+            ++m_version;
+            m_layouts.clear();
+            m_history.clear();
+            m_styles.reset(m_text.size());
+            m_matches.clear();
+            m_matches_pending = false;
+        }
+        addChanges(changes);
+        redraw();
+    }
+    
     void GuiTextEditor::addCaret(sCaret caret)
     {
         if(caret)
@@ -394,140 +694,372 @@ namespace Kiwi
     void GuiTextEditor::setCaretPosition(const sCaret caret, const double limit) const noexcept
     {
         lock_guard<mutex> guard(m_text_mutex);
-        if(m_wrapped)
+        caret->position = getLayout(limit).getPosition(m_text, caret->caret);
+    }
+    
+    TextLayout& GuiTextEditor::getLayout(const double width) const noexcept
+    {
+        const double key = (m_wrapped && width > 0.) ? width : 0.;
+        if(!m_layouts.count(key))
         {
-            const size_type linebreak = m_text.find_last_of(L'\n', caret->caret);
-            if(linebreak == npos)
+            const vector<sGuiView> views(getViews());
+            for(auto it = m_layouts.begin(); it != m_layouts.end();)
             {
-                Size offset;
-                size_type pos = 0;
-                wstring line(1ul, m_text[pos]);
-                offset.width(m_font.getLineWidth(line));
-                while(pos <= caret->caret)
+                const double other = it->first;
+                if(none_of(views.begin(), views.end(), [this, other](sGuiView const& view)
                 {
-                    if(offset.width() > limit)
-                    {
-                        offset.height(offset.height() + m_font.getHeight());
-                        line.clear();
-                        line += m_text[pos];
-                    }
-                    line += m_text[++pos];
-                    offset.width(m_font.getLineWidth(line));
+                    return (m_wrapped && view->getSize().width() > 0. ? view->getSize().width() : 0.) == other;
+                }))
+                {
+                    it = m_layouts.erase(it);
+                }
+                else
+                {
+                    ++it;
                 }
-                //caret->setPosition(Point(offset.width(), offset.height()));
+            }
+            TextLayout& layout = m_layouts[key];
+            layout.setFont(m_font);
+            layout.setStyles(&m_styles);
+            layout.setLineHeight(getLineHeight());
+            layout.setJustification(m_justification);
+            layout.setWrapped(m_wrapped);
+        }
+        
+        // When the lines aren't wrapped, the width is only the reference of the justification and doesn't invalidate the layout.
+        TextLayout& layout = m_layouts[key];
+        layout.setWidth(m_wrapped ? key : width);
+        return layout;
+    }
+    
+    void GuiTextEditor::replaceAtCarets(vector<sCaret> const& carets, wstring const& text) noexcept
+    {
+        struct Range
+        {
+            ulong first;
+            ulong second;
+        };
+        
+        struct Lines
+        {
+            ulong first;
+            ulong removed;
+            ulong inserted;
+        };
+        
+        // The selections are sorted and the overlapping ones are merged, each caret keeps the index of its range.
+        vector<sCaret> sorted(carets);
+        sort(sorted.begin(), sorted.end(), [](sCaret const& a, sCaret const& b) {return a->first() < b->first();});
+        vector<Range>  ranges;
+        vector<ulong>  indices;
+        for(auto caret : sorted)
+        {
+            if(!ranges.empty() && (caret->first() < ranges.back().second || (caret->empty() && ulong(caret->first()) == ranges.back().first && ranges.back().first == ranges.back().second)))
+            {
+                ranges.back().second = max(ranges.back().second, ulong(caret->second()));
             }
             else
             {
-                Size offset = m_font.getTextSize(wstring(m_text, 0ul, linebreak), limit);
-                size_type pos = linebreak+1;
-                wstring line(1ul, m_text[pos]);
-                offset.width(m_font.getLineWidth(line));
-                while(pos <= caret->caret)
+                const Range range = {ulong(caret->first()), ulong(caret->second())};
+                ranges.push_back(range);
+            }
+            indices.push_back(ulong(ranges.size()) - 1ul);
+        }
+        if(ranges.empty() || (text.empty() && all_of(ranges.begin(), ranges.end(), [](Range const& r) {return r.first == r.second;})))
+        {
+            return;
+        }
+        
+        const ulong length = ulong(text.size());
+        map<double, Rows> rows;
+        vector<long> shifts(ranges.size() + 1ul, 0l);
+        vector<Change> edits;
+        vector<Lines>  lines;
+        edits.reserve(ranges.size());
+        {
+            lock_guard<mutex> guard(m_text_mutex);
+            if(ranges.size() == 1ul)
+            {
+                const ulong last = m_text.getLineIndex(ranges[0].second) + 1ul;
+                for(auto& layout : m_layouts)
                 {
-                    if(offset.width() > limit)
+                    const Rows edited = {layout.second.getCharacterRow(m_text, ranges[0].first ? ranges[0].first - 1ul : 0ul), layout.second.getLineRow(m_text, last), 0ul};
+                    rows[layout.first] = edited;
+                }
+            }
+            
+            // Only the text and the styles are edited for each range, the lines edited on the same line are merged.
+            for(ulong i = ulong(ranges.size()); i > 0ul; i--)
+            {
+                Range const& range = ranges[i - 1ul];
+                const ulong size = range.second - range.first;
+                if(size || length)
+                {
+                    const ulong first   = m_text.getLineIndex(range.first);
+                    const ulong removed = m_text.getLineIndex(range.second) - first;
+                    TextHistory::Edit edit = {range.first, m_text.extract(range.first, size), TextBuffer()};
+                    m_text.erase(range.first, size);
+                    m_text.insert(range.first, text.data(), length);
+                    edit.inserted = m_text.extract(range.first, length);
+                    m_styles.replace(range.first, size, length);
+                    const ulong inserted = edit.inserted.getNumberOfLines() - 1ul;
+                    if(!lines.empty() && first + removed == lines.back().first)
                     {
-                        offset.height(offset.height() + m_font.getHeight());
-                        line.clear();
-                        line += m_text[pos];
+                        lines.back().first     = first;
+                        lines.back().removed  += removed;
+                        lines.back().inserted += inserted;
                     }
-                    line += m_text[++pos];
-                    offset.width(m_font.getLineWidth(line));
+                    else
+                    {
+                        const Lines edited = {first, removed, inserted};
+                        lines.push_back(edited);
+                    }
+                    edits.push_back(move(edit));
                 }
-                //caret->setPosition(Point(offset.width(), offset.height()));
             }
-        }
-        else
-        {
-            if(caret->caret == 0ul)
+            m_history.record(edits);
+            ++m_version;
+            
+            // The shift of a range is the sum of the differences of the ranges before it.
+            for(ulong i = 0; i < ulong(ranges.size()); i++)
             {
-                //caret->setPosition(Point());
+                shifts[i + 1ul] = shifts[i] + long(length) - long(ranges[i].second - ranges[i].first);
             }
-            else
+            
+            // The paragraphs of the edited lines are replaced in each layout from the last ones, so the indices remain valid.
+            for(auto& layout : m_layouts)
             {
-                size_type linebreak = m_text.find_last_of(L'\n', caret->caret - ulong(m_text[caret->caret] == L'\n'));
-                if(linebreak == npos) {
-                    //caret->setPosition(Point(m_font.getLineWidth(wstring(m_text, 0ul, caret->caret)), 0.));
+                for(auto const& edited : lines)
+                {
+                    layout.second.replace(edited.first, edited.removed, edited.inserted);
                 }
-                else {
-                    Point pos(m_font.getLineWidth(wstring(m_text, linebreak + 1ul, caret->caret - linebreak - 1ul)), m_font.getHeight());
-                    if(linebreak != 0ul) {
-                        linebreak = m_text.find_last_of(L'\n', linebreak - 1ul);
-                        while(linebreak != npos)
-                        {
-                            pos.y(pos.y() + m_font.getHeight());
-                            if(linebreak == 0ul) {
-                                linebreak = npos;
-                            }
-                            else {
-                                linebreak = m_text.find_last_of(L'\n', max(linebreak, 1ul) - 1ul);
-                            }
-                        }
-                    }
-                    //caret->setPosition(pos);
+                if(ranges.size() == 1ul)
+                {
+                    rows[layout.first].current = layout.second.getLineRow(m_text, m_text.getLineIndex(ranges[0].first + length) + 1ul);
                 }
             }
             
+            // The occurences of the highlighted text are moved with the shifts in one pass,
+            // only the characters around the ranges are scanned again.
+            const ulong size = ulong(m_search.size());
+            if(size && !m_matches_pending)
+            {
+                vector<ulong> matches;
+                matches.reserve(m_matches.size());
+                auto it = m_matches.cbegin();
+                ulong scanned = 0ul;
+                for(ulong i = 0; i < ulong(ranges.size()); i++)
+                {
+                    const ulong from = ranges[i].first >= size - 1ul ? ranges[i].first - size + 1ul : 0ul;
+                    for(; it != m_matches.cend() && *it < from; ++it)
+                    {
+                        matches.push_back(ulong(long(*it) + shifts[i]));
+                    }
+                    while(it != m_matches.cend() && *it < ranges[i].second)
+                    {
+                        ++it;
+                    }
+                    const ulong pos   = ulong(long(ranges[i].first) + shifts[i]);
+                    const ulong start = max(scanned, pos >= size - 1ul ? pos - size + 1ul : 0ul);
+                    const ulong stop  = pos + length;
+                    if(start < stop)
+                    {
+                        const vector<ulong> found = m_text.findAll(m_search, start, stop - start, m_search_sensitive);
+                        matches.insert(matches.end(), found.begin(), found.end());
+                    }
+                    scanned = max(scanned, stop);
+                }
+                for(; it != m_matches.cend(); ++it)
+                {
+                    matches.push_back(ulong(long(*it) + shifts.back()));
+                }
+                m_matches.swap(matches);
+            }
+            for(ulong i = 0; i < ulong(sorted.size()); i++)
+            {
+                sorted[i]->start = sorted[i]->caret = ulong(long(ranges[indices[i]].first) + shifts[indices[i]]) + length;
+                sorted[i]->dist  = npos;
+            }
         }
-    }
-                
-    void GuiTextEditor::eraseAtCaret(const sCaret caret)
-    {
-        if(!caret->empty())
+        
+        // The carets of the other views are moved with the text.
+        auto relocate = [&ranges, &shifts, length](const ulong pos) -> ulong
         {
-            m_redraw = true;
+            const ulong index = ulong(upper_bound(ranges.begin(), ranges.end(), pos, [](const ulong p, Range const& r) {return p <= r.first;}) - ranges.begin());
+            if(index && pos < ranges[index - 1ul].second)
             {
-                lock_guard<mutex> guard(m_text_mutex);
-                m_text.erase(caret->first(), caret->second());
-                caret->start = caret->caret = caret->first();
-                caret->dist  = npos;
+                return ulong(long(ranges[index - 1ul].first) + shifts[index - 1ul]) + length;
             }
-            vector<sListener> listeners(getListeners());
-            for(auto it : listeners)
+            return ulong(long(pos) + shifts[index]);
+        };
+        for(auto caret : getCarets())
+        {
+            if(std::find(sorted.begin(), sorted.end(), caret) == sorted.end())
             {
-                it->textChanged(static_pointer_cast<GuiTextEditor>(shared_from_this()));
+                caret->caret = relocate(caret->caret);
+                caret->start = relocate(caret->start);
+                caret->dist  = npos;
             }
-            vector<sCaret> carets(getCarets());
-            for(auto it : carets)
+        }
+        
+        addChanges(edits);
+        if(ranges.size() == 1ul)
+        {
+            redrawRows(rows);
+        }
+        else
+        {
+            redraw();
+        }
+    }
+    
+    void GuiTextEditor::undo() noexcept
+    {
+        vector<TextHistory::Edit> edits;
+        {
+            lock_guard<mutex> guard(m_text_mutex);
+            edits = m_history.undo();
+        }
+        applyEdits(edits);
+    }
+    
+    void GuiTextEditor::redo() noexcept
+    {
+        vector<TextHistory::Edit> edits;
+        {
+            lock_guard<mutex> guard(m_text_mutex);
+            edits = m_history.redo();
+        }
+        applyEdits(edits);
+    }
+    
+    void GuiTextEditor::setHistoryLimit(const ulong limit) noexcept
+    {
+        lock_guard<mutex> guard(m_text_mutex);
+        m_history.setLimit(limit);
+    }
+    
+    void GuiTextEditor::applyEdits(vector<TextHistory::Edit> const& edits) noexcept
+    {
+        if(!edits.empty())
+        {
+            ulong position = 0ul;
             {
-                //it->textChanged(static_pointer_cast<GuiTextEditor>(shared_from_this()));
+                lock_guard<mutex> guard(m_text_mutex);
+                for(auto const& edit : edits)
+                {
+                    const ulong first   = m_text.getLineIndex(edit.pos);
+                    const ulong removed = m_text.getLineIndex(edit.pos + edit.removed.size()) - first;
+                    m_text.erase(edit.pos, edit.removed.size());
+                    m_text.insert(edit.pos, edit.inserted);
+                    m_styles.replace(edit.pos, edit.removed.size(), edit.inserted.size());
+                    updateMatches(edit.pos, edit.removed.size(), edit.inserted.size());
+                    for(auto& layout : m_layouts)
+                    {
+                        layout.second.replace(first, removed, edit.inserted.getNumberOfLines() - 1ul);
+                    }
+                    position = edit.pos + edit.inserted.size();
+                }
+                ++m_version;
             }
-            if(m_redraw)
+            for(auto caret : getCarets())
             {
-                redraw();
+                caret->start = caret->caret = position;
+                caret->dist  = npos;
             }
+            addChanges(edits);
+            redraw();
         }
     }
     
-    void GuiTextEditor::insertAtCaret(const sCaret caret, wstring const& text) noexcept
+    void GuiTextEditor::addChanges(vector<Change> const& changes) noexcept
     {
-        if(!text.empty())
+        if(!changes.empty())
         {
-            m_redraw = true;
+            bool schedule;
             {
-                lock_guard<mutex> guard(m_text_mutex);
-                if(!caret->empty())
+                lock_guard<mutex> guard(m_changes_mutex);
+                schedule = m_changes.empty();
+                for(auto const& change : changes)
                 {
-                    m_text.erase(caret->first(), caret->second() - caret->first());
-                    caret->start = caret->caret = caret->first();
-                    caret->dist  = npos;
+                    // The characters typed one after the other are merged in one change.
+                    if(!m_changes.empty() && change.removed.empty() && m_changes.back().pos + m_changes.back().inserted.size() == change.pos)
+                    {
+                        m_changes.back().inserted.insert(m_changes.back().inserted.size(), change.inserted);
+                    }
+                    else
+                    {
+                        m_changes.push_back(change);
+                    }
                 }
-                m_text.insert(caret->caret, text);
             }
-            caret->start = caret->caret = min(caret->caret + text.size(), m_text.size());
-            
+            if(schedule)
+            {
+                sGuiContext context = getContext();
+                if(context)
+                {
+                    const wGuiTextEditor editor = static_pointer_cast<GuiTextEditor>(shared_from_this());
+                    context->requestAnimationFrame([editor](const double time)
+                    {
+                        sGuiTextEditor that = editor.lock();
+                        if(that)
+                        {
+                            that->flushChanges();
+                        }
+                    });
+                }
+                else
+                {
+                    flushChanges();
+                }
+            }
+        }
+    }
+    
+    void GuiTextEditor::flushChanges() noexcept
+    {
+        vector<Change> changes;
+        {
+            lock_guard<mutex> guard(m_changes_mutex);
+            changes.swap(m_changes);
+        }
+        if(!changes.empty())
+        {
             vector<sListener> listeners(getListeners());
             for(auto it : listeners)
             {
-                it->textChanged(static_pointer_cast<GuiTextEditor>(shared_from_this()));
+                it->textChanged(static_pointer_cast<GuiTextEditor>(shared_from_this()), changes);
             }
-            vector<sCaret> carets(getCarets());
-            for(auto it : carets)
+        }
+    }
+    
+    void GuiTextEditor::redrawCaret(Caret const& caret) noexcept
+    {
+        redraw(Rectangle(caret.position.x() - 1., caret.position.y(), 2., getLineHeight()));
+    }
+    
+    void GuiTextEditor::redrawRows(map<double, Rows> const& rows) noexcept
+    {
+        const double height = getLineHeight();
+        for(auto view : getViews())
+        {
+            const Size size = view->getSize();
+            auto it = rows.find((m_wrapped && size.width() > 0.) ? size.width() : 0.);
+            if(it != rows.end())
             {
-                //it->textChanged(static_pointer_cast<GuiTextEditor>(shared_from_this()));
+                Rows const& edited = it->second;
+                view->invalidate(Rectangle(0., double(edited.top) * height, size.width(), double(edited.current - edited.top) * height));
+                
+                // The rows after the edited lines are only moved when the number of rows changed.
+                const double origin = double(min(edited.previous, edited.current)) * height;
+                if(edited.previous != edited.current && origin < size.height())
+                {
+                    view->scroll(Rectangle::withEdges(0., origin, size.width(), size.height()), Point(0., (double(edited.current) - double(edited.previous)) * height));
+                }
             }
-            if(m_redraw)
+            else
             {
-                redraw();
+                view->invalidate();
             }
         }
     }
@@ -561,17 +1093,6 @@ namespace Kiwi
             ++caret->caret;
         }
         caret->dist = npos;
-        
-        cout << "next"<< endl;
-        if(caret->empty())
-        {
-            wcout << m_text[caret->caret - 1ul] << endl;
-        }
-        else
-        {
-            cout << caret->second() - caret->first()<< endl;
-            wcout << wstring(m_text, caret->first(), caret->second() - caret->first()) << endl;
-        }
     }
     
     void GuiTextEditor::moveCaretToPreviousCharacter(const sCaret caret, const bool select) noexcept
@@ -588,10 +1109,8 @@ namespace Kiwi
     
     void GuiTextEditor::moveCaretToStartLine(const sCaret caret, const bool select) noexcept
     {
-        int tosee;
         lock_guard<mutex> guard(m_text_mutex);
-        const size_type line = (caret->caret != 0ul) ? m_text.find_last_of(L'\n', caret->caret - 1ul) : 0ul;
-        caret->caret = (line == npos) ? 0ul : min(line + 1ul, m_text.size());
+        caret->caret = m_text.getLineStart(m_text.getLineIndex(caret->caret));
         if(!select) {
             caret->start = caret->caret;
         }
@@ -601,8 +1120,7 @@ namespace Kiwi
     void GuiTextEditor::moveCaretToEndLine(const sCaret caret, const bool select) noexcept
     {
         lock_guard<mutex> guard(m_text_mutex);
-        const size_type line = m_text.find_first_of(L'\n', caret->caret);
-        caret->caret = (line == npos) ? m_text.size() : line;
+        caret->caret = m_text.getLineEnd(m_text.getLineIndex(caret->caret));
         if(!select) {
             caret->start = caret->caret;
         }
@@ -613,19 +1131,15 @@ namespace Kiwi
     {
         lock_guard<mutex> guard(m_text_mutex);
         const size_type current = select ? caret->caret : caret->first();
-        size_type line = (current > 0ul) ? m_text.find_last_of(L'\n', current -  1ul) + 1 : 0ul;
-        if(line == npos) {
-            line = 0ul;
-        }
+        const ulong line = m_text.getLineIndex(current);
         if(caret->dist == npos) {
-            caret->dist = current - (line);
+            caret->dist = current - m_text.getLineStart(line);
         }
         if(line == 0ul) {
             caret->caret = 0ul;
         }
-        else{
-            const size_type pline = (line > 2ul) ? m_text.find_last_of(L'\n', max(line -  2ul, 0ul)) + 1 : 0ul;
-            caret->caret = min(pline + caret->dist, m_text.find_first_of(L'\n', pline));
+        else {
+            caret->caret = min(m_text.getLineStart(line - 1ul) + caret->dist, m_text.getLineEnd(line - 1ul));
         }
         if(!select) {
             caret->start = caret->caret;
@@ -635,7 +1149,20 @@ namespace Kiwi
     void GuiTextEditor::moveCaretToBottomCharacter(const sCaret caret, const bool select) noexcept
     {
         lock_guard<mutex> guard(m_text_mutex);
-        int todo;
+        const size_type current = select ? caret->caret : caret->second();
+        const ulong line = m_text.getLineIndex(current);
+        if(caret->dist == npos) {
+            caret->dist = current - m_text.getLineStart(line);
+        }
+        if(line + 1ul >= m_text.getNumberOfLines()) {
+            caret->caret = m_text.size();
+        }
+        else {
+            caret->caret = min(m_text.getLineStart(line + 1ul) + caret->dist, m_text.getLineEnd(line + 1ul));
+        }
+        if(!select) {
+            caret->start = caret->caret;
+        }
     }
     
     void GuiTextEditor::moveCaretToNextWord(const sCaret caret, const bool select) noexcept
@@ -645,13 +1172,13 @@ namespace Kiwi
             caret->caret = caret->second();
         }
         if(m_text[caret->caret] == L' ' || m_text[caret->caret] == L'\n' || m_text[caret->caret] == L'\t') {
-            caret->caret = m_text.find_first_not_of(L" \n\t", caret->caret);
+            caret->caret = m_text.findFirstNotOf(L" \n\t", caret->caret);
         }
         if(caret->caret == npos) {
             caret->caret = m_text.size();
         }
         else {
-            caret->caret = m_text.find_first_of(L" \n\t", caret->caret);
+            caret->caret = m_text.findFirstOf(L" \n\t", caret->caret);
             if(caret->caret == npos) {
                 caret->caret = m_text.size();
             }
@@ -669,16 +1196,16 @@ namespace Kiwi
             caret->caret = caret->second();
         }
         if(m_text[caret->caret] == L' ' || m_text[caret->caret] == L'\n' || m_text[caret->caret] == L'\t') {
-            caret->caret = m_text.find_last_not_of(L" \n\t", caret->caret);
+            caret->caret = m_text.findLastNotOf(L" \n\t", caret->caret);
         }
         else if(caret->caret){
-            caret->caret = m_text.find_last_not_of(L" \n\t", caret->caret - 1ul);
+            caret->caret = m_text.findLastNotOf(L" \n\t", caret->caret - 1ul);
         }
         if(caret->caret == npos) {
             caret->caret = 0ul;
         }
         else {
-            caret->caret = m_text.find_last_of(L" \n\t", caret->caret);
+            caret->caret = m_text.findLastOf(L" \n\t", caret->caret);
             caret->caret = (caret->caret == npos) ? 0ul : caret->caret + 1ul;
         }
         if(!select) {
@@ -686,6 +1213,17 @@ namespace Kiwi
         }
         caret->dist  = npos;
     }
+    
+    void GuiTextEditor::moveCaretToPoint(const sCaret caret, Point const& pt, const bool select, const double limit) noexcept
+    {
+        lock_guard<mutex> guard(m_text_mutex);
+        caret->caret = getLayout(limit).getCaret(m_text, pt);
+        m_history.close();
+        if(!select) {
+            caret->start = caret->caret;
+        }
+        caret->dist  = npos;
+    }
 
     // ================================================================================ //
     //                              TEXT EDITOR CONTROLLER                              //
@@ -695,6 +1233,7 @@ namespace Kiwi
         m_caret(make_shared<GuiTextEditor::Caret>(editor))
     {
         m_editor->addCaret(m_caret);
+        m_carets.push_back(m_caret);
         shouldReceiveMouse(true);
         shouldReceiveKeyboard(true);
         shouldReceiveActions(true);
@@ -702,27 +1241,82 @@ namespace Kiwi
         
     GuiTextEditor::Controller::~Controller() noexcept
     {
+        removeExtraCarets();
         m_editor->removeCaret(m_caret);
     }
     
+    void GuiTextEditor::Controller::removeExtraCarets() noexcept
+    {
+        for(ulong i = 1; i < ulong(m_carets.size()); i++)
+        {
+            m_editor->removeCaret(m_carets[i]);
+        }
+        m_carets.resize(1ul);
+    }
+    
     void GuiTextEditor::Controller::draw(sGuiView view, Sketch& sketch)
     {
         const Size viewSize = getView()->getSize();
-        m_editor->setCaretPosition(m_caret, viewSize.width());
+        for(auto caret : m_carets)
+        {
+            m_editor->setCaretPosition(caret, viewSize.width());
+        }
         m_editor->draw(getView(), sketch);
+        
+        const double height = m_editor->getLineHeight();
+        for(auto caret : m_carets)
+        {
+            if(caret->m_status)
+            {
+                sketch.setColor(caret->getColor());
+                sketch.setLineWidth(2.);
+                sketch.drawLine(caret->position, caret->position + Point(0., height));
+            }
+        }
     }
         
     bool GuiTextEditor::Controller::receive(sGuiView view, MouseEvent const& event)
     {
+        if(event.isDown() || event.isDrag())
+        {
+            const Size viewSize = getView()->getSize();
+            m_editor->setCaretPosition(m_caret, viewSize.width());
+            if(event.isDown() && event.hasAlt())
+            {
+                // Alt + click adds a caret, the edits are then applied at all the carets.
+                const GuiTextEditor::sCaret caret = make_shared<GuiTextEditor::Caret>(m_editor);
+                m_editor->addCaret(caret);
+                m_carets.push_back(caret);
+                m_editor->moveCaretToPoint(caret, event.getPosition(), false, viewSize.width());
+                sGuiContext context = m_editor->getContext();
+                if(context)
+                {
+                    context->startBlinking(caret);
+                }
+            }
+            else
+            {
+                if(event.isDown() && !event.hasShift())
+                {
+                    removeExtraCarets();
+                }
+                m_editor->moveCaretToPoint(m_carets.back(), event.getPosition(), event.isDrag() || event.hasShift(), viewSize.width());
+            }
+            m_editor->setCaretPosition(m_carets.back(), viewSize.width());
+            m_editor->redraw();
+        }
         return true;
     }
     
     bool GuiTextEditor::Controller::receive(sGuiView view, KeyboardEvent const& event)
     {
-        if(m_editor->receive(m_caret, event))
+        if(m_editor->receive(m_carets, event))
         {
             const Size viewSize = getView()->getSize();
-            m_editor->setCaretPosition(m_caret, viewSize.width());
+            for(auto caret : m_carets)
+            {
+                m_editor->setCaretPosition(caret, viewSize.width());
+            }
             return true;
         }
         else
@@ -733,17 +1327,34 @@ namespace Kiwi
     
     bool GuiTextEditor::Controller::receive(sGuiView view, KeyboardFocus const event)
     {
-        int decomment_later; // And remove from constructor and destructor
-        /*
-        if(event == KeyboardFocusIn)
+        // The carets only blink while the editor has the focus.
+        sGuiContext context = m_editor->getContext();
+        for(auto caret : m_carets)
         {
-            m_editor->addChild(m_caret);
+            if(event == KeyboardFocusIn)
+            {
+                if(context)
+                {
+                    context->startBlinking(caret);
+                }
+            }
+            else
+            {
+                if(context)
+                {
+                    context->stopBlinking(caret);
+                }
+                caret->blink(false);
+            }
         }
-        else
+        if(event == KeyboardFocusOut)
         {
-            m_editor->removeChild(m_caret);
+            vector<sListener> listeners(m_editor->getListeners());
+            for(auto it : listeners)
+            {
+                it->focusLost(m_editor);
+            }
         }
-         */
         return true;
     }
         
@@ -765,29 +1376,13 @@ namespace Kiwi
         }
     }
     
-    void GuiTextEditor::Caret::viewCreated(sGuiView view) noexcept
-    {
-        if(!m_active)
-        {
-            m_active = true;
-            m_status = true;
-            redraw();
-            delay(500.);
-        }
-    }
-    
-    void GuiTextEditor::Caret::viewRemoved(sGuiView view) noexcept
-    {
-        m_active = false;
-    }
-    
-    void GuiTextEditor::Caret::tick()
+    void GuiTextEditor::Caret::blink(const bool visible) noexcept
     {
-        if(m_active)
+        m_status = visible;
+        sGuiTextEditor editor = m_editor.lock();
+        if(editor)
         {
-            m_status = !m_status;
-            redraw();
-            delay(500.);
+            editor->redrawCaret(*this);
         }
     }
 }
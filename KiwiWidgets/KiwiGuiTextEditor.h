@@ -24,88 +24,10 @@
 #ifndef __DEF_KIWI_GUI_TEXT_EDITOR__
 #define __DEF_KIWI_GUI_TEXT_EDITOR__
 
-#include "KiwiGuiViewport.h"
+#include "KiwiGuiText.h"
 
 namespace Kiwi
 {
-    class Text
-    {
-        static wstring_convert<codecvt_utf8<wchar_t>> m_converter;
-        class Line
-        {
-        private:
-            wstring m_text;
-        public:
-            inline Line() noexcept {}
-            inline Line(wchar_t c) noexcept : m_text(1ul, c) {}
-            inline Line(wstring const& text) noexcept : m_text(text) {}
-            inline Line(wstring&& text) noexcept {m_text.swap(text);}
-            
-            inline bool empty() const noexcept {return m_text.empty();}
-            inline ulong size() const noexcept {return ulong(m_text.size());}
-            inline wstring& text() noexcept {return m_text;}
-            inline wstring const& text() const noexcept {return m_text;}
-            
-        };
-    private:
-      
-    public:
-        static const ulong npos = -1;
-        Font            m_font;
-        vector<Line>    m_lines;
-        
-        inline Text() noexcept {};
-        inline Text(char c) noexcept {m_lines.push_back(Line(m_converter.from_bytes(c)));}
-        inline Text(wchar_t c) noexcept {m_lines.push_back(Line(c));}
-        inline Text(string const& text) noexcept {m_lines.push_back(Line(m_converter.from_bytes(text)));}
-        inline Text(wstring const& text) noexcept {m_lines.push_back(Line(text));}
-        inline Text(wstring&& text) noexcept {m_lines.push_back(Line(forward<wstring>(text)));}
-        inline ~Text() {m_lines.clear();}
-        
-        inline bool empty() const noexcept {return m_lines.empty();}
-        inline ulong size() const noexcept {return ulong(m_lines.size());}
-        
-        inline void erase(ulong start, ulong end) noexcept
-        {
-            if(start > end) {
-                swap(start, end);
-            }
-            ulong pos = 0, sl = npos, se = npos;
-            for(ulong i = 0; i < m_lines.size(); i++)
-            {
-                pos += m_lines[i].size();
-                if(sl == npos && pos > start) {
-                    sl = i;
-                }
-                if(pos > end) {
-                    se = i; break;
-                }
-            }
-            if(sl != npos && se != npos)
-            {
-                
-            }
-        }
-        
-        inline void insert(const ulong pos, string const& text) noexcept
-        {
-            
-        }
-        
-        inline Size getTextSize(const double limit = 0.) const noexcept
-        {
-            if(!empty())
-            {
-                Size size = m_font.getTextSize(m_lines[0].text(), limit);
-                for(ulong i = 1; i < ulong(m_lines.size()); i++) {
-                    size += m_font.getTextSize(m_lines[i].text(), limit);
-                }
-                return size;
-            }
-            return Size();
-        }
-    };
-    
     // ================================================================================ //
     //                                     TEXT EDITOR                                  //
     // ================================================================================ //
@@ -122,6 +44,9 @@ namespace Kiwi
         typedef shared_ptr<Listener>    sListener;
         typedef weak_ptr<Listener>      wListener;
         
+        class Snapshot;
+        typedef shared_ptr<const Snapshot> scSnapshot;
+        
         enum BehaviorMode //: bool
         {
             UsedAsCharacter = false,
@@ -131,6 +56,11 @@ namespace Kiwi
         typedef wstring::size_type size_type;
         static const size_type npos = -1;
         
+        //! A change of the text.
+        /** The change replaces the removed characters by the inserted characters at a position, the characters are shared with the text of the editor.
+         */
+        typedef TextHistory::Edit Change;
+        
     private:
         class Caret;
         typedef shared_ptr<Caret>       sCaret;
@@ -140,16 +70,33 @@ namespace Kiwi
         typedef shared_ptr<Controller>  sController;
         typedef weak_ptr<Controller>    wController;
         
+        //! The rows modified by an edit in the layout of a width.
+        struct Rows
+        {
+            ulong top;
+            ulong previous;
+            ulong current;
+        };
+        
         Font                    m_font;
         Font::Justification     m_justification;
         double                  m_line_space;
         bool                    m_wrapped;
         Color                   m_color;
         
-        wstring                 m_text;
+        TextBuffer              m_text;
+        mutable map<double,
+        TextLayout>             m_layouts;
+        TextHistory             m_history;
+        TextStyles              m_styles;
+        atomic<ulong>           m_version;
+        mutable scSnapshot      m_snapshot;
+        wstring                 m_search;
+        bool                    m_search_sensitive;
+        mutable vector<ulong>   m_matches;
+        mutable bool            m_matches_pending;
         mutable mutex           m_text_mutex;
         double                  m_empty_width;
-        atomic_bool             m_redraw;
         
         bool                    m_notify_return;
         bool                    m_notify_tab;
@@ -161,6 +108,9 @@ namespace Kiwi
         set<wCaret,
         owner_less<wCaret>>     m_carets;
         mutable mutex           m_carets_mutex;
+        
+        vector<Change>          m_changes;
+        mutex                   m_changes_mutex;
     public:
         
         //! Constructor.
@@ -233,16 +183,39 @@ namespace Kiwi
          */
         void setText(wstring const& text) noexcept;
         
+        //! Loads the text of the editor from a file.
+        /** The function sets the text of the editor with the content of a UTF-8 file. The file is mapped in memory and only the parts of the text that are displayed or edited are decoded.
+         @param path The path of the file.
+         @return true if the file has been loaded, otherwise false.
+         */
+        bool loadFile(string const& path) noexcept;
+        
         //! Clears the text of the editor.
         /** The function clears the text of the editor.
          */
         void clearText() noexcept;
         
+        //! Undoes the last edit.
+        /** The function undoes the last transaction of the history, the consecutive characters typed are undone together.
+         */
+        void undo() noexcept;
+        
+        //! Redoes the last undone edit.
+        /** The function redoes the last transaction undone.
+         */
+        void redo() noexcept;
+        
+        //! Sets the memory limit of the history.
+        /** The function sets the maximum memory used by the undo history, the oldest edits are forgotten when the limit is exceeded.
+         @param limit The limit in bytes.
+         */
+        void setHistoryLimit(const ulong limit) noexcept;
+        
         //! Retrieves the font of the editor.
         /** The function retrieves the font of the editor. 
          @return The font.
          */
-        inline Font getFont() const noexcept
+        inline Font const& getFont() const noexcept
         {
             return m_font;
         }
@@ -307,11 +280,62 @@ namespace Kiwi
          */
         inline wstring getText() const noexcept
         {
-            return m_text;
+            lock_guard<mutex> guard(m_text_mutex);
+            return m_text.getText();
         }
         
+        //! Retrieves a snapshot of the text.
+        /** The function retrieves an immutable snapshot of the text that shares the pieces of the text of the editor, so nothing is copied and the snapshot can be read by any thread while the text is edited. The same snapshot is returned until the text changes.
+         @return The snapshot.
+         */
+        scSnapshot getSnapshot() const noexcept;
+        
+        //! Retrieves the version of the text.
+        /** The function retrieves the version of the text, that is incremented each time the text changes. The function doesn't lock, so it can be polled to know if a snapshot is outdated.
+         @return The version.
+         */
+        inline ulong getVersion() const noexcept
+        {
+            return m_version;
+        }
+        
+        //! Sets the style of a range of characters.
+        /** The function sets the color, the background color and the font style of a range of characters. The styles are stored as runs that move with the text when it is edited, and the characters inserted take the style of the character before them. Only the rows of the range are redrawn.
+         @param pos     The position of the first character.
+         @param size    The number of characters.
+         @param style   The style or null to use the font and the color of the editor.
+         */
+        void setStyle(const ulong pos, const ulong size, TextStyles::scStyle const& style) noexcept;
+        
+        //! Removes the styles of the text.
+        /** The function removes the styles of the text, the text uses the font and the color of the editor.
+         */
+        void clearStyles() noexcept;
+        
+        //! Finds a text.
+        /** The function finds the first occurence of a text from a position.
+         @param text        The text.
+         @param pos         The position where to start.
+         @param sensitive   false if the case should be ignored.
+         @return The position of the occurence or npos.
+         */
+        ulong find(wstring const& text, const ulong pos = 0ul, const bool sensitive = true) const noexcept;
+        
+        //! Sets the text to highlight.
+        /** The function sets the text whose occurences are highlighted. When the text extends the previous one, only the previous occurences are verified. When the text of the editor changes, only the edited region is scanned again. When the whole text is replaced, only the visible rows are scanned until all the occurences are requested.
+         @param text        The text or an empty text to remove the highlighting.
+         @param sensitive   false if the case should be ignored.
+         */
+        void setSearch(wstring const& text, const bool sensitive = true) noexcept;
+        
+        //! Retrieves the occurences of the highlighted text.
+        /** The function retrieves the positions of the occurences of the text to highlight.
+         @return The sorted positions of the occurences.
+         */
+        vector<ulong> getMatches() const noexcept;
+        
         //! Retrieves the size of the text.
-        /** The function retrieves the size of the text. If the width limit is superior to zero, the function computes the size of the text like if the lines were wrapped.
+        /** The function retrieves the size of the text laid out in a view of a width, it's answered by the layout of the width. If the lines are wrapped and the width limit is superior to zero, the lines are wrapped within the limit and the first query of a width measures all the lines. Otherwise, the width of the text only accounts for the lines that have been displayed or queried, so it's approximate for a large text whose lines have never been read.
          @param limit The width limit.
          @return The size of the text.
          */
@@ -341,8 +365,19 @@ namespace Kiwi
          */
         void removeListener(sListener listener);
         
+        //! Notifies the listeners of the pending changes.
+        /** The changes of the text are delivered to the listeners once per frame, the function delivers the pending changes immediately.
+         */
+        void flushChanges() noexcept;
+        
     private:
         
+        //! Adds changes to the pending changes.
+        /** The function adds changes to the pending changes, merges the consecutive characters typed and schedules the notification of the listeners.
+         @param changes The changes in the order they have been applied.
+         */
+        void addChanges(vector<Change> const& changes) noexcept;
+        
         //! Adds a caret in the binding list of the text editor.
         /** The function adds the caret in the binding list of the text editor.
          @param caret  The caret.
@@ -362,25 +397,70 @@ namespace Kiwi
          */
         void setCaretPosition(const sCaret caret, const double limit = 0.) const noexcept;
         
+        //! Retrieves the layout of a width.
+        /** The function retrieves the layout of the text for the width of a view, the views with the same width share a layout. When the lines aren't wrapped, all the views share one layout. When a layout is created, the layouts of the widths that no view has anymore are released. The text must be locked.
+         @param width The width of the view.
+         @return The layout.
+         */
+        TextLayout& getLayout(const double width) const noexcept;
+        
         //! The text editor keybaord receive method.
-        /** The function adds character on move the caret.
-         @param caret The caret.
+        /** The function adds character on move the carets.
+         @param carets The carets.
          @return true if the class has done something with the event otherwise false
          */
-        bool receive(const sCaret caret, KeyboardEvent const& event);
+        bool receive(vector<sCaret> const& carets, KeyboardEvent const& event);
         
-        //! Erases the text at the caret.
-        /** The function erases the caret's selection and notifies the other carets.
-         @param caret  The caret.
+        //! Erases the text at the carets.
+        /** The function erases the selections of the carets in one edit and updates the other carets.
+         @param carets  The carets.
          */
-        void eraseAtCaret(const sCaret caret);
+        inline void eraseAtCarets(vector<sCaret> const& carets) noexcept {replaceAtCarets(carets, wstring());}
         
-        //! Insert text at the caret.
-        /** The function inserts text at the caret's selection and notifies the other carets.
-         @param caret  The caret.
-         @param text   The text.
+        //! Insert text at the carets.
+        /** The function replaces the selections of the carets by a text in one edit and updates the other carets.
+         @param carets  The carets.
+         @param text    The text.
          */
-        void insertAtCaret(const sCaret caret, wstring const& text) noexcept;
+        inline void insertAtCarets(vector<sCaret> const& carets, wstring const& text) noexcept {if(!text.empty()) replaceAtCarets(carets, text);}
+        
+        //! Replaces the selections of carets by a text.
+        /** The function replaces the selections of the carets by a text in a single pass over the buffer, from the last selection to the first so the positions don't need to be recomputed. The overlapping selections are merged, the layouts, the occurences of the highlighted text and the positions of all the carets are updated once, then the listeners are notified and the editor is redrawn once.
+         @param carets  The carets.
+         @param text    The text.
+         */
+        void replaceAtCarets(vector<sCaret> const& carets, wstring const& text) noexcept;
+        
+        //! Applies edits of the history.
+        /** The function applies the edits retrieved from the history, moves the carets after the last one and notifies the listeners.
+         @param edits The edits.
+         */
+        void applyEdits(vector<TextHistory::Edit> const& edits) noexcept;
+        
+        //! Updates the occurences of the highlighted text after an edit.
+        /** The function removes the occurences that overlap an edit, moves the following ones and scans the edited region again. The text must be locked.
+         @param pos         The position of the edit.
+         @param removed     The number of characters removed.
+         @param inserted    The number of characters inserted.
+         */
+        void updateMatches(const ulong pos, const ulong removed, const ulong inserted) noexcept;
+        
+        //! Finds the pending occurences of the highlighted text.
+        /** The function scans the whole text for the occurences of the highlighted text if it has been replaced since the last scan. The text must be locked.
+         */
+        void findPendingMatches() const noexcept;
+        
+        //! Redraws a caret.
+        /** The function redraws the area of a caret in the views.
+         @param caret The caret.
+         */
+        void redrawCaret(Caret const& caret) noexcept;
+        
+        //! Redraws the rows modified by an edit.
+        /** The function redraws the rows of the edited lines in the views and moves the rows below if the number of rows changed. A view whose width has no layout is entirely redrawn.
+         @param rows The rows modified in the layout of each width.
+         */
+        void redrawRows(map<double, Rows> const& rows) noexcept;
         
         //! Moves the caret to the begining of the text.
         /** The function moves the caret to the begining of the text (cmd + top).
@@ -452,6 +532,15 @@ namespace Kiwi
          */
         void moveCaretToPreviousWord(const sCaret caret, const bool select) noexcept;
         
+        //! Moves the caret to a point.
+        /** The function moves the caret to the character that is the closest of a point (click).
+         @param caret The caret.
+         @param pt    The point relative to the text editor.
+         @param select true if only the caret move (shift or drag).
+         @param limit The width limit.
+         */
+        void moveCaretToPoint(const sCaret caret, Point const& pt, const bool select, const double limit = 0.) noexcept;
+        
         //! Create the controller.
         /** The function creates a controller depending on the inheritance.
          @return The controller.
@@ -542,6 +631,13 @@ namespace Kiwi
          */
         virtual void textChanged(sGuiTextEditor editor) {}
         
+        //! Receives the changes of the text.
+        /** The function notifies the listener of the changes of the text since the last notification, at most once per frame. The changes must be applied in order, so the listener doesn't need to retrieve the whole text. The default implementation calls textChanged without the changes.
+         @param editor  The text editor that notifies.
+         @param changes The changes.
+         */
+        virtual void textChanged(sGuiTextEditor editor, vector<Change> const& changes) {textChanged(editor);}
+        
         //! Receives the notification that the return key has been pressed.
         /** The function notifies the listener that the return key has been pressed.
          @param editor The text editor that notifies.
@@ -567,11 +663,47 @@ namespace Kiwi
         virtual void focusLost(sGuiTextEditor editor) {}
     };
     
+    //! The snapshot of the text editor.
+    /**
+     The snapshot is an immutable version of the text of the editor.
+     */
+    class GuiTextEditor::Snapshot
+    {
+    private:
+        const TextBuffer    m_text;
+        const ulong         m_version;
+    public:
+        
+        //! Constructor.
+        /** The function initializes a snapshot, the pieces of the text are shared.
+         @param text    The text.
+         @param version The version of the text.
+         */
+        inline Snapshot(TextBuffer const& text, const ulong version) noexcept : m_text(text), m_version(version) {}
+        
+        //! Destructor.
+        /** The function does nothing.
+         */
+        inline ~Snapshot() noexcept {}
+        
+        //! Retrieves the text.
+        /** The function retrieves the text of the snapshot.
+         @return The text.
+         */
+        inline TextBuffer const& getText() const noexcept {return m_text;}
+        
+        //! Retrieves the version.
+        /** The function retrieves the version of the text of the snapshot.
+         @return The version.
+         */
+        inline ulong getVersion() const noexcept {return m_version;}
+    };
+    
     //! The caret of the text editor.
     /**
      The caret...
      */
-    class GuiTextEditor::Caret : public GuiModel, public Clock
+    class GuiTextEditor::Caret : public GuiModel, public GuiContext::Blinkable
     {
     public:
         typedef wstring::size_type size_type;
@@ -579,13 +711,14 @@ namespace Kiwi
     private:
         friend class GuiTextEditor;
         
+        const wGuiTextEditor    m_editor;
         atomic_bool             m_status;
-        atomic_bool             m_active;
         Color                   m_color;
         
         size_type               caret;
         size_type               start;
         size_type               dist;
+        Point                   position;
     public:
         
         //! Constructor.
@@ -593,8 +726,8 @@ namespace Kiwi
          @param context The context.
          */
         inline Caret(sGuiTextEditor editor) noexcept : GuiModel(editor->getContext()),
+        m_editor(editor),
         m_status(false),
-        m_active(false),
         m_color(Colors::black),
         caret(0ul),
         start(0ul),
@@ -648,22 +781,11 @@ namespace Kiwi
          */
         void draw(scGuiView view, Sketch& sketch) const;
         
-        //! Receives the notification that a view has been created.
-        /** The function notfies the model that a view has been created.
-         @param view The view.
-         */
-        void viewCreated(sGuiView view) noexcept override;
-        
-        //! Receives the notification that a view has been removed.
-        /** The function notfies the model that a view has been removed.
-         @param view The view.
+        //! Receives the phase of the blinking.
+        /** The function shows or hides the caret and only redraws the area of the caret in the views of the text editor. The carets blink with the timer of the context while their text editor has the focus.
+         @param visible true if the caret should be shown, otherwise false.
          */
-        void viewRemoved(sGuiView view) noexcept override;
-        
-        //! The tick function that must be override.
-        /** The tick function is called by a clock after a delay.
-         */
-        void tick() override;
+        void blink(const bool visible) noexcept override;
         
         //! Notify the manager that the values of an attribute has changed.
         /** The function notifies the manager that the values of an attribute has changed.
@@ -690,8 +812,12 @@ namespace Kiwi
     class GuiTextEditor::Controller : public GuiController
     {
     private:
-        const sGuiTextEditor        m_editor;
-        const GuiTextEditor::sCaret m_caret;
+        const sGuiTextEditor            m_editor;
+        const GuiTextEditor::sCaret     m_caret;
+        vector<GuiTextEditor::sCaret>   m_carets;
+        
+        //! @internal
+        void removeExtraCarets() noexcept;
     public:
         
         //! The controller constructor.
@@ -0,0 +1,211 @@
+/*
+ ==============================================================================
+ 
+ This file is part of the KIWI library.
+ Copyright (c) 2014 Pierre Guillot & Eliott Paris.
+ 
+ Permission is granted to use this software under the terms of either:
+ a) the GPL v2 (or any later version)
+ b) the Affero GPL v3
+ 
+ Details of these licenses can be found at: www.gnu.org/licenses
+ 
+ KIWI is distributed in the hope that it will be useful, but WITHOUT ANY
+ WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ 
+ ------------------------------------------------------------------------------
+ 
+ To release a closed-source product which uses KIWI, contact : guillotpierre6@gmail.com
+ 
+ ==============================================================================
+ */
+
+
+#include "KiwiGuiTextHistory.h"
+#include <chrono>
+
+namespace Kiwi
+{
+    // ================================================================================ //
+    //                                      TEXT HISTORY                                //
+    // ================================================================================ //
+    
+    static double getTextHistoryTime() noexcept
+    {
+        return chrono::duration<double, milli>(chrono::steady_clock::now().time_since_epoch()).count();
+    }
+    
+    TextHistory::TextHistory(const ulong limit) noexcept :
+    m_memory(0ul),
+    m_limit(limit),
+    m_delay(1000.),
+    m_time(0.),
+    m_open(false)
+    {
+        ;
+    }
+    
+    TextHistory::~TextHistory() noexcept
+    {
+        clear();
+    }
+    
+    ulong TextHistory::getMemorySize(Edit const& edit) noexcept
+    {
+        // The inserted characters are still in the buffer when the edit is recorded, the removed ones may only be kept by the history.
+        return ulong(sizeof(Edit)) + edit.removed.getMemorySize() + edit.inserted.getMemorySize() + edit.removed.size() * ulong(sizeof(wchar_t));
+    }
+    
+    bool TextHistory::coalesce(Edit const& edit) noexcept
+    {
+        if(!m_open || m_undo.empty())
+        {
+            return false;
+        }
+        Transaction& transaction = m_undo.back();
+        Edit& last = transaction.edits.back();
+        const ulong memory = getMemorySize(last);
+        if(edit.removed.empty() && edit.pos == last.pos + last.inserted.size())
+        {
+            last.inserted.insert(last.inserted.size(), edit.inserted);
+        }
+        else if(edit.inserted.empty() && last.inserted.empty() && edit.pos + edit.removed.size() == last.pos)
+        {
+            last.removed.insert(0ul, edit.removed);
+            last.pos = edit.pos;
+        }
+        else if(edit.inserted.empty() && last.inserted.empty() && edit.pos == last.pos)
+        {
+            last.removed.insert(last.removed.size(), edit.removed);
+        }
+        else
+        {
+            return false;
+        }
+        transaction.memory += getMemorySize(last) - memory;
+        m_memory           += getMemorySize(last) - memory;
+        return true;
+    }
+    
+    void TextHistory::shrink() noexcept
+    {
+        // The redo transactions are accounted like the undo ones, the stack that goes the farthest from the current state is shortened.
+        while(m_memory > m_limit && m_undo.size() + m_redo.size() > 1ul)
+        {
+            if(m_undo.size() >= m_redo.size())
+            {
+                m_memory -= m_undo.front().memory;
+                m_undo.pop_front();
+            }
+            else
+            {
+                m_memory -= m_redo.front().memory;
+                m_redo.pop_front();
+            }
+        }
+    }
+    
+    void TextHistory::record(const ulong pos, TextBuffer const& removed, TextBuffer const& inserted) noexcept
+    {
+        if(removed.empty() && inserted.empty())
+        {
+            return;
+        }
+        for(auto const& transaction : m_redo)
+        {
+            m_memory -= transaction.memory;
+        }
+        m_redo.clear();
+        
+        const double time = getTextHistoryTime();
+        const Edit edit = {pos, removed, inserted};
+        if(time - m_time > m_delay || !coalesce(edit))
+        {
+            Transaction transaction;
+            transaction.edits.push_back(edit);
+            transaction.memory = getMemorySize(edit);
+            m_memory += transaction.memory;
+            m_undo.push_back(move(transaction));
+        }
+        
+        // A new line ends the transaction like a word processor does.
+        m_time = time;
+        m_open = inserted.getNumberOfLines() == 1ul;
+        shrink();
+    }
+    
+    void TextHistory::record(vector<Edit> const& edits) noexcept
+    {
+        if(edits.size() == 1ul)
+        {
+            record(edits[0].pos, edits[0].removed, edits[0].inserted);
+        }
+        else if(!edits.empty())
+        {
+            for(auto const& transaction : m_redo)
+            {
+                m_memory -= transaction.memory;
+            }
+            m_redo.clear();
+            
+            Transaction transaction;
+            transaction.edits  = edits;
+            transaction.memory = 0ul;
+            for(auto const& edit : edits)
+            {
+                transaction.memory += getMemorySize(edit);
+            }
+            m_memory += transaction.memory;
+            m_undo.push_back(move(transaction));
+            m_time = getTextHistoryTime();
+            m_open = false;
+            shrink();
+        }
+    }
+    
+    vector<TextHistory::Edit> TextHistory::undo() noexcept
+    {
+        vector<Edit> edits;
+        m_open = false;
+        if(!m_undo.empty())
+        {
+            Transaction& transaction = m_undo.back();
+            for(auto it = transaction.edits.rbegin(); it != transaction.edits.rend(); ++it)
+            {
+                const Edit edit = {it->pos, it->inserted, it->removed};
+                edits.push_back(edit);
+            }
+            m_redo.push_back(move(transaction));
+            m_undo.pop_back();
+        }
+        return edits;
+    }
+    
+    vector<TextHistory::Edit> TextHistory::redo() noexcept
+    {
+        vector<Edit> edits;
+        m_open = false;
+        if(!m_redo.empty())
+        {
+            edits = m_redo.back().edits;
+            m_undo.push_back(move(m_redo.back()));
+            m_redo.pop_back();
+        }
+        return edits;
+    }
+    
+    void TextHistory::clear() noexcept
+    {
+        m_undo.clear();
+        m_redo.clear();
+        m_memory = 0ul;
+        m_open   = false;
+    }
+    
+    void TextHistory::setLimit(const ulong limit) noexcept
+    {
+        m_limit = limit;
+        shrink();
+    }
+}
@@ -0,0 +1,164 @@
+/*
+ ==============================================================================
+ 
+ This file is part of the KIWI library.
+ Copyright (c) 2014 Pierre Guillot & Eliott Paris.
+ 
+ Permission is granted to use this software under the terms of either:
+ a) the GPL v2 (or any later version)
+ b) the Affero GPL v3
+ 
+ Details of these licenses can be found at: www.gnu.org/licenses
+ 
+ KIWI is distributed in the hope that it will be useful, but WITHOUT ANY
+ WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ 
+ ------------------------------------------------------------------------------
+ 
+ To release a closed-source product which uses KIWI, contact : guillotpierre6@gmail.com
+ 
+ ==============================================================================
+ */
+
+
+#ifndef __DEF_KIWI_GUI_TEXT_HISTORY__
+#define __DEF_KIWI_GUI_TEXT_HISTORY__
+
+#include "KiwiGuiTextLayout.h"
+
+namespace Kiwi
+{
+    // ================================================================================ //
+    //                                      TEXT HISTORY                                //
+    // ================================================================================ //
+    
+    //! The text history.
+    /** The text history records the edits of a text buffer to undo and redo them. An edit only keeps the pieces of the removed and the inserted characters, that refer to the blocks of the buffer, so the characters are never copied. The consecutive edits of a typing session are coalesced in one transaction, and the transactions the farthest from the current state of the text, to undo or to redo, are discarded when the memory of the history exceeds its limit.
+     */
+    class TextHistory
+    {
+    public:
+        
+        //! An edit.
+        /** The edit replaces the removed characters by the inserted characters at a position.
+         */
+        struct Edit
+        {
+            ulong       pos;
+            TextBuffer  removed;
+            TextBuffer  inserted;
+        };
+        
+    private:
+        struct Transaction
+        {
+            vector<Edit>    edits;
+            ulong           memory;
+        };
+        
+        list<Transaction>   m_undo;
+        list<Transaction>   m_redo;
+        ulong               m_memory;
+        ulong               m_limit;
+        double              m_delay;
+        double              m_time;
+        bool                m_open;
+        
+        //! @internal
+        static ulong getMemorySize(Edit const& edit) noexcept;
+        
+        //! @internal
+        bool coalesce(Edit const& edit) noexcept;
+        
+        //! @internal
+        void shrink() noexcept;
+        
+    public:
+        
+        //! Constructor.
+        /** The function initializes an empty history.
+         @param limit The maximum memory of the history in bytes.
+         */
+        TextHistory(const ulong limit = 1ul << 20) noexcept;
+        
+        //! Destructor.
+        /** The function frees the history.
+         */
+        ~TextHistory() noexcept;
+        
+        //! Records an edit.
+        /** The function records an edit that has been applied to the buffer. The edit is added to the current transaction if it continues the previous one, otherwise a new transaction is created. The edits that could be redone are discarded.
+         @param pos         The position of the edit.
+         @param removed     The removed characters.
+         @param inserted    The inserted characters.
+         */
+        void record(const ulong pos, TextBuffer const& removed, TextBuffer const& inserted) noexcept;
+        
+        //! Records several edits.
+        /** The function records edits that have been applied to the buffer in order as one transaction, for example an edit at several carets. A single edit can be coalesced with the previous ones.
+         @param edits The edits.
+         */
+        void record(vector<Edit> const& edits) noexcept;
+        
+        //! Closes the current transaction.
+        /** The function closes the current transaction so the next edit will create a new one, for example when the caret is moved.
+         */
+        inline void close() noexcept {m_open = false;}
+        
+        //! Retrieves the edits to undo.
+        /** The function closes the last transaction and retrieves the edits that undo it, they must be applied to the buffer in order.
+         @return The edits or nothing if there is nothing to undo.
+         */
+        vector<Edit> undo() noexcept;
+        
+        //! Retrieves the edits to redo.
+        /** The function retrieves the edits that redo the last undone transaction, they must be applied to the buffer in order.
+         @return The edits or nothing if there is nothing to redo.
+         */
+        vector<Edit> redo() noexcept;
+        
+        //! Retrieves if an edit can be undone.
+        /** The function retrieves if an edit can be undone.
+         @return true if an edit can be undone, otherwise false.
+         */
+        inline bool canUndo() const noexcept {return !m_undo.empty();}
+        
+        //! Retrieves if an edit can be redone.
+        /** The function retrieves if an edit can be redone.
+         @return true if an edit can be redone, otherwise false.
+         */
+        inline bool canRedo() const noexcept {return !m_redo.empty();}
+        
+        //! Clears the history.
+        /** The function removes all the transactions.
+         */
+        void clear() noexcept;
+        
+        //! Sets the memory limit.
+        /** The function sets the maximum memory of the history, the transactions to undo and to redo share the limit. The transactions the farthest from the current state of the text are discarded first, from the oldest one to undo or the last one to redo, but the closest one is always kept.
+         @param limit The limit in bytes.
+         */
+        void setLimit(const ulong limit) noexcept;
+        
+        //! Retrieves the memory limit.
+        /** The function retrieves the maximum memory of the history.
+         @return The limit in bytes.
+         */
+        inline ulong getLimit() const noexcept {return m_limit;}
+        
+        //! Retrieves the memory used.
+        /** The function retrieves the memory used by the transactions to undo and to redo, that is the pieces of the edits and the characters that were removed.
+         @return The size in bytes.
+         */
+        inline ulong getMemorySize() const noexcept {return m_memory;}
+        
+        //! Sets the coalescing delay.
+        /** The function sets the maximum delay between two edits of the same transaction.
+         @param ms The delay in milliseconds.
+         */
+        inline void setCoalescingDelay(const double ms) noexcept {m_delay = ms;}
+    };
+}
+
+#endif
@@ -0,0 +1,539 @@
+/*
+ ==============================================================================
+ 
+ This file is part of the KIWI library.
+ Copyright (c) 2014 Pierre Guillot & Eliott Paris.
+ 
+ Permission is granted to use this software under the terms of either:
+ a) the GPL v2 (or any later version)
+ b) the Affero GPL v3
+ 
+ Details of these licenses can be found at: www.gnu.org/licenses
+ 
+ KIWI is distributed in the hope that it will be useful, but WITHOUT ANY
+ WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ 
+ ------------------------------------------------------------------------------
+ 
+ To release a closed-source product which uses KIWI, contact : guillotpierre6@gmail.com
+ 
+ ==============================================================================
+ */
+
+
+#include "KiwiGuiTextLayout.h"
+#include "KiwiGuiTextStyles.h"
+
+namespace Kiwi
+{
+    // ================================================================================ //
+    //                                      TEXT LAYOUT                                 //
+    // ================================================================================ //
+    
+    struct TextLayout::Node
+    {
+        uNode       left;
+        uNode       right;
+        Paragraph   paragraph;
+        uint32_t    priority;
+        ulong       size;
+        ulong       rows;
+        ulong       invalid;
+        double      width;
+        
+        Node(const uint32_t p) noexcept : priority(p), size(1ul), rows(1ul), invalid(1ul), width(0.)
+        {
+            paragraph.width = 0.;
+            paragraph.valid = false;
+        }
+    };
+    
+    TextLayout::TextLayout() noexcept :
+    m_styles(nullptr),
+    m_justification(Font::Justification::TopLeft),
+    m_width(0.),
+    m_line_height(m_font.getHeight()),
+    m_wrapped(false),
+    m_seed(0x27D4EB2Fu)
+    {
+        for(unsigned i = 0; i < 8u; i++)
+        {
+            m_faces[i] = m_font;
+            m_faces[i].setStyle(Font::Style(i));
+        }
+    }
+    
+    TextLayout::~TextLayout() noexcept
+    {
+        m_root.reset();
+    }
+    
+    uint32_t TextLayout::random() noexcept
+    {
+        m_seed ^= m_seed << 13;
+        m_seed ^= m_seed >> 17;
+        m_seed ^= m_seed << 5;
+        return m_seed;
+    }
+    
+    ulong TextLayout::getSize(uNode const& node) noexcept
+    {
+        return node ? node->size : 0ul;
+    }
+    
+    ulong TextLayout::getRows(uNode const& node) noexcept
+    {
+        return node ? node->rows : 0ul;
+    }
+    
+    ulong TextLayout::getRows(Paragraph const& paragraph) noexcept
+    {
+        // A paragraph that hasn't been measured is one row, like any paragraph when the lines aren't wrapped.
+        return paragraph.valid ? ulong(paragraph.rows.size()) : 1ul;
+    }
+    
+    ulong TextLayout::getInvalid(uNode const& node) noexcept
+    {
+        return node ? node->invalid : 0ul;
+    }
+    
+    double TextLayout::getWidth(uNode const& node) noexcept
+    {
+        return node ? node->width : 0.;
+    }
+    
+    void TextLayout::pull(Node& node) noexcept
+    {
+        Paragraph const& paragraph = node.paragraph;
+        node.size    = getSize(node.left) + 1ul + getSize(node.right);
+        node.rows    = getRows(node.left) + getRows(paragraph) + getRows(node.right);
+        node.invalid = getInvalid(node.left) + (paragraph.valid ? 0ul : 1ul) + getInvalid(node.right);
+        node.width   = max(max(getWidth(node.left), getWidth(node.right)), paragraph.valid ? paragraph.width : 0.);
+    }
+    
+    void TextLayout::split(uNode node, const ulong pos, uNode& left, uNode& right) noexcept
+    {
+        if(!node)
+        {
+            left.reset();
+            right.reset();
+        }
+        else if(pos <= getSize(node->left))
+        {
+            uNode l;
+            split(move(node->left), pos, left, l);
+            node->left = move(l);
+            pull(*node);
+            right = move(node);
+        }
+        else
+        {
+            uNode r;
+            split(move(node->right), pos - getSize(node->left) - 1ul, r, right);
+            node->right = move(r);
+            pull(*node);
+            left = move(node);
+        }
+    }
+    
+    TextLayout::uNode TextLayout::merge(uNode left, uNode right) noexcept
+    {
+        if(!left)
+        {
+            return right;
+        }
+        else if(!right)
+        {
+            return left;
+        }
+        else if(left->priority > right->priority)
+        {
+            left->right = merge(move(left->right), move(right));
+            pull(*left);
+            return left;
+        }
+        else
+        {
+            right->left = merge(move(left), move(right->left));
+            pull(*right);
+            return right;
+        }
+    }
+    
+    void TextLayout::invalidate(uNode const& node) noexcept
+    {
+        if(node)
+        {
+            invalidate(node->left);
+            invalidate(node->right);
+            node->paragraph.valid = false;
+            pull(*node);
+        }
+    }
+    
+    TextLayout::uNode TextLayout::build(const ulong size) noexcept
+    {
+        if(!size)
+        {
+            return nullptr;
+        }
+        
+        // The paragraphs are built as a balanced tree, a node takes the priorities of its children to remain a treap.
+        const ulong half = size / 2ul;
+        uNode node(new Node(random()));
+        node->left  = build(half);
+        node->right = build(size - half - 1ul);
+        node->priority = max(node->priority, max(node->left ? node->left->priority : 0u, node->right ? node->right->priority : 0u));
+        pull(*node);
+        return node;
+    }
+    
+    void TextLayout::setFont(Font const& font) noexcept
+    {
+        if(font != m_font)
+        {
+            m_font = font;
+            for(unsigned i = 0; i < 8u; i++)
+            {
+                m_faces[i] = font;
+                m_faces[i].setStyle(Font::Style(i));
+            }
+            invalidate();
+        }
+    }
+    
+    void TextLayout::setStyles(TextStyles const* styles) noexcept
+    {
+        if(styles != m_styles)
+        {
+            m_styles = styles;
+            invalidate();
+        }
+    }
+    
+    void TextLayout::setWidth(const double width) noexcept
+    {
+        if(width != m_width)
+        {
+            m_width = width;
+            if(m_wrapped)
+            {
+                invalidate();
+            }
+        }
+    }
+    
+    void TextLayout::setWrapped(const bool wrap) noexcept
+    {
+        if(wrap != m_wrapped)
+        {
+            m_wrapped = wrap;
+            invalidate();
+        }
+    }
+    
+    void TextLayout::setLineHeight(const double height) noexcept
+    {
+        m_line_height = height;
+    }
+    
+    void TextLayout::setJustification(const Font::Justification justification) noexcept
+    {
+        m_justification = justification;
+    }
+    
+    void TextLayout::invalidate() noexcept
+    {
+        invalidate(m_root);
+    }
+    
+    void TextLayout::replace(const ulong first, const ulong removed, const ulong inserted) noexcept
+    {
+        if(first + removed < getSize(m_root))
+        {
+            uNode left, middle, right;
+            split(move(m_root), first, left, middle);
+            split(move(middle), removed + 1ul, middle, right);
+            m_root = merge(merge(move(left), build(inserted + 1ul)), move(right));
+        }
+        else
+        {
+            // The layout was not synchronized with the buffer, it will be rebuilt on the next query.
+            m_root.reset();
+        }
+    }
+    
+    void TextLayout::measure(TextBuffer const& buffer, const ulong line, Paragraph& paragraph) const noexcept
+    {
+        const double limit = (m_wrapped && m_width > 0.) ? m_width : 0.;
+        const ulong start = buffer.getLineStart(line);
+        const wstring text = buffer.getText(start, buffer.getLineEnd(line) - start);
+        const ulong size = ulong(text.size());
+        vector<double> widths(size);
+        if(size && m_styles && m_styles->size() >= start + size)
+        {
+            // The characters are measured with the font of their run, so the positions agree with the drawing.
+            m_styles->visit(start, size, [this, start, &text, &widths](const ulong pos, const ulong length, TextStyles::scStyle const& style)
+            {
+                Font const& font = style ? getFont(style->face) : m_font;
+                font.getCharacterWidths(text.data() + (pos - start), length, widths.data() + (pos - start));
+            });
+        }
+        else if(size)
+        {
+            m_font.getCharacterWidths(text.data(), size, widths.data());
+        }
+        
+        paragraph.advances.resize(size + 1ul);
+        paragraph.advances[0] = 0.;
+        for(ulong j = 0; j < size; j++)
+        {
+            paragraph.advances[j+1] = paragraph.advances[j] + widths[j];
+        }
+        
+        // The lines are wrapped on the word boundaries like the text runs.
+        paragraph.rows.clear();
+        paragraph.width = 0.;
+        for(auto const& row : TextRun::getLines(text.data(), widths.data(), size, limit))
+        {
+            paragraph.rows.push_back(row.start);
+            paragraph.width = max(paragraph.width, row.width);
+        }
+        paragraph.valid = true;
+    }
+    
+    void TextLayout::measure(TextBuffer const& buffer, uNode const& node, const ulong offset) noexcept
+    {
+        // Only the subtrees that contain paragraphs to measure are visited.
+        if(getInvalid(node))
+        {
+            const ulong index = offset + getSize(node->left);
+            measure(buffer, node->left, offset);
+            if(!node->paragraph.valid)
+            {
+                measure(buffer, index, node->paragraph);
+            }
+            measure(buffer, node->right, index + 1ul);
+            pull(*node);
+        }
+    }
+    
+    TextLayout::Paragraph const& TextLayout::getParagraph(TextBuffer const& buffer, ulong line, ulong& row) noexcept
+    {
+        const ulong index = line;
+        vector<Node*> path;
+        Node* node = m_root.get();
+        row = 0ul;
+        while(true)
+        {
+            path.push_back(node);
+            const ulong lsize = getSize(node->left);
+            if(line < lsize)
+            {
+                node = node->left.get();
+            }
+            else if(line == lsize || !node->right)
+            {
+                row += getRows(node->left);
+                break;
+            }
+            else
+            {
+                row  += getRows(node->left) + getRows(node->paragraph);
+                line -= lsize + 1ul;
+                node  = node->right.get();
+            }
+        }
+        
+        // The paragraph is measured and the sums of the nodes above it are updated.
+        if(!node->paragraph.valid)
+        {
+            measure(buffer, index, node->paragraph);
+            for(auto it = path.rbegin(); it != path.rend(); ++it)
+            {
+                pull(**it);
+            }
+        }
+        return node->paragraph;
+    }
+    
+    ulong TextLayout::getLine(ulong index, ulong& row) const noexcept
+    {
+        Node const* node = m_root.get();
+        ulong line = 0ul;
+        row = 0ul;
+        while(node)
+        {
+            const ulong lrows = getRows(node->left);
+            const ulong prows = getRows(node->paragraph);
+            if(index < lrows)
+            {
+                node = node->left.get();
+            }
+            else if(index < lrows + prows || !node->right)
+            {
+                row += lrows;
+                return line + getSize(node->left);
+            }
+            else
+            {
+                index -= lrows + prows;
+                row   += lrows + prows;
+                line  += getSize(node->left) + 1ul;
+                node   = node->right.get();
+            }
+        }
+        return line;
+    }
+    
+    void TextLayout::update(TextBuffer const& buffer) noexcept
+    {
+        const ulong nlines = buffer.getNumberOfLines();
+        if(getSize(m_root) != nlines)
+        {
+            m_root = build(nlines);
+        }
+        
+        // When the lines aren't wrapped, a paragraph is always one row and it is only measured when it is queried,
+        // so the characters of a large text that are never displayed aren't read.
+        if(m_wrapped && m_width > 0.)
+        {
+            measure(buffer, m_root, 0ul);
+        }
+    }
+    
+    double TextLayout::getOffset(const double width) const noexcept
+    {
+        if(m_width > 0. && m_justification & Font::Justification::Right)
+        {
+            return m_width - width;
+        }
+        else if(m_width > 0. && m_justification & Font::Justification::HorizontallyCentered)
+        {
+            return (m_width - width) * 0.5;
+        }
+        return 0.;
+    }
+    
+    ulong TextLayout::getNumberOfRows(TextBuffer const& buffer) noexcept
+    {
+        update(buffer);
+        return getRows(m_root);
+    }
+    
+    ulong TextLayout::getRowIndex(TextBuffer const& buffer, const double y) noexcept
+    {
+        update(buffer);
+        if(m_line_height > 0. && y > 0.)
+        {
+            return min(ulong(y / m_line_height), getRows(m_root) - 1ul);
+        }
+        return 0ul;
+    }
+    
+    ulong TextLayout::getCharacterRow(TextBuffer const& buffer, const ulong pos) noexcept
+    {
+        update(buffer);
+        ulong first;
+        const ulong line = buffer.getLineIndex(pos);
+        Paragraph const& paragraph = getParagraph(buffer, line, first);
+        const ulong column = min(min(pos, buffer.size()) - buffer.getLineStart(line), ulong(paragraph.advances.size()) - 1ul);
+        return first + ulong(upper_bound(paragraph.rows.begin(), paragraph.rows.end(), column) - paragraph.rows.begin()) - 1ul;
+    }
+    
+    ulong TextLayout::getLineRow(TextBuffer const& buffer, const ulong line) noexcept
+    {
+        update(buffer);
+        ulong row = 0ul, index = line;
+        Node const* node = m_root.get();
+        while(node)
+        {
+            const ulong lsize = getSize(node->left);
+            if(index < lsize)
+            {
+                node = node->left.get();
+            }
+            else if(index == lsize)
+            {
+                return row + getRows(node->left);
+            }
+            else
+            {
+                row   += getRows(node->left) + getRows(node->paragraph);
+                index -= lsize + 1ul;
+                node   = node->right.get();
+            }
+        }
+        return row;
+    }
+    
+    TextLayout::Row TextLayout::getRow(TextBuffer const& buffer, const ulong index) noexcept
+    {
+        update(buffer);
+        ulong first;
+        const ulong current = min(index, getRows(m_root) - 1ul);
+        const ulong line    = getLine(current, first);
+        Paragraph const& paragraph = getParagraph(buffer, line, first);
+        const ulong row     = current - first;
+        const ulong start   = buffer.getLineStart(line);
+        const ulong begin   = paragraph.rows[row];
+        const ulong end     = (row + 1ul < ulong(paragraph.rows.size())) ? paragraph.rows[row+1] : ulong(paragraph.advances.size()) - 1ul;
+        const double width  = paragraph.advances[end] - paragraph.advances[begin];
+        const Row result    = {start + begin, start + end, getOffset(width), double(current) * m_line_height, width};
+        return result;
+    }
+    
+    Size TextLayout::getSize(TextBuffer const& buffer) noexcept
+    {
+        if(buffer.empty())
+        {
+            return Size(0., 0.);
+        }
+        update(buffer);
+        return Size(getWidth(m_root), double(getRows(m_root)) * m_line_height);
+    }
+    
+    Point TextLayout::getPosition(TextBuffer const& buffer, const ulong pos) noexcept
+    {
+        update(buffer);
+        ulong origin;
+        const ulong line = buffer.getLineIndex(pos);
+        Paragraph const& paragraph = getParagraph(buffer, line, origin);
+        const ulong size    = ulong(paragraph.advances.size()) - 1ul;
+        const ulong column  = min(min(pos, buffer.size()) - buffer.getLineStart(line), size);
+        const ulong row     = ulong(upper_bound(paragraph.rows.begin(), paragraph.rows.end(), column) - paragraph.rows.begin()) - 1ul;
+        const ulong first   = paragraph.rows[row];
+        const ulong last    = (row + 1ul < ulong(paragraph.rows.size())) ? paragraph.rows[row+1] : size;
+        const double width  = paragraph.advances[last] - paragraph.advances[first];
+        return Point(getOffset(width) + paragraph.advances[column] - paragraph.advances[first], double(origin + row) * m_line_height);
+    }
+    
+    ulong TextLayout::getCaret(TextBuffer const& buffer, Point const& pt) noexcept
+    {
+        ulong origin;
+        const ulong index = getRowIndex(buffer, pt.y());
+        const ulong line = getLine(index, origin);
+        Paragraph const& paragraph = getParagraph(buffer, line, origin);
+        const ulong row     = index - origin;
+        const ulong size    = ulong(paragraph.advances.size()) - 1ul;
+        const ulong first   = paragraph.rows[row];
+        
+        // The end of a wrapped row is the start of the next one, so the caret stops before the last character.
+        const bool wrapped  = row + 1ul < ulong(paragraph.rows.size());
+        const ulong last    = wrapped ? paragraph.rows[row+1] : size;
+        const ulong limit   = wrapped ? last - 1ul : last;
+        
+        const double x = pt.x() - getOffset(paragraph.advances[last] - paragraph.advances[first]) + paragraph.advances[first];
+        ulong column = ulong(lower_bound(paragraph.advances.begin() + first, paragraph.advances.begin() + limit + 1ul, x) - paragraph.advances.begin());
+        if(column > limit)
+        {
+            column = limit;
+        }
+        else if(column > first && x - paragraph.advances[column-1] < paragraph.advances[column] - x)
+        {
+            --column;
+        }
+        return buffer.getLineStart(line) + column;
+    }
+}
@@ -0,0 +1,262 @@
+/*
+ ==============================================================================
+ 
+ This file is part of the KIWI library.
+ Copyright (c) 2014 Pierre Guillot & Eliott Paris.
+ 
+ Permission is granted to use this software under the terms of either:
+ a) the GPL v2 (or any later version)
+ b) the Affero GPL v3
+ 
+ Details of these licenses can be found at: www.gnu.org/licenses
+ 
+ KIWI is distributed in the hope that it will be useful, but WITHOUT ANY
+ WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ 
+ ------------------------------------------------------------------------------
+ 
+ To release a closed-source product which uses KIWI, contact : guillotpierre6@gmail.com
+ 
+ ==============================================================================
+ */
+
+
+#ifndef __DEF_KIWI_GUI_TEXT_LAYOUT__
+#define __DEF_KIWI_GUI_TEXT_LAYOUT__
+
+#include "KiwiGuiTextBuffer.h"
+
+namespace Kiwi
+{
+    class TextStyles;
+    
+    // ================================================================================ //
+    //                                      TEXT LAYOUT                                 //
+    // ================================================================================ //
+    
+    //! The text layout.
+    /** The text layout positions the characters of a text buffer. Each line of the buffer is a paragraph that stores the prefix sums of the advances of its characters and the positions where it wraps, so the position of a character or the character under a point are found with binary searches. The paragraphs are the nodes of a treap that sums their rows, so the first row of a line, the line of a row and the replacement of paragraphs are logarithmic in the number of lines. When the text changes, only the paragraphs touched by the edit are laid out again, lazily on the next query. When the lines aren't wrapped, a paragraph is only measured when one of its rows is queried.
+     */
+    class TextLayout
+    {
+    public:
+        
+        //! A displayed line.
+        /** The row is the range of characters of a displayed line and its position.
+         */
+        struct Row
+        {
+            ulong   start;
+            ulong   end;
+            double  x;
+            double  y;
+            double  width;
+        };
+        
+    private:
+        struct Paragraph
+        {
+            vector<double>  advances;
+            vector<ulong>   rows;
+            double          width;
+            bool            valid;
+        };
+        
+        struct Node;
+        typedef unique_ptr<Node> uNode;
+        
+        Font                m_font;
+        array<Font, 8>      m_faces;
+        TextStyles const*   m_styles;
+        Font::Justification m_justification;
+        double              m_width;
+        double              m_line_height;
+        bool                m_wrapped;
+        uNode               m_root;
+        uint32_t            m_seed;
+        
+        //! @internal
+        uint32_t random() noexcept;
+        
+        //! @internal
+        static ulong getSize(uNode const& node) noexcept;
+        
+        //! @internal
+        static ulong getRows(uNode const& node) noexcept;
+        
+        //! @internal
+        static ulong getRows(Paragraph const& paragraph) noexcept;
+        
+        //! @internal
+        static ulong getInvalid(uNode const& node) noexcept;
+        
+        //! @internal
+        static double getWidth(uNode const& node) noexcept;
+        
+        //! @internal
+        static void pull(Node& node) noexcept;
+        
+        //! @internal
+        static void split(uNode node, const ulong pos, uNode& left, uNode& right) noexcept;
+        
+        //! @internal
+        static uNode merge(uNode left, uNode right) noexcept;
+        
+        //! @internal
+        static void invalidate(uNode const& node) noexcept;
+        
+        //! @internal
+        uNode build(const ulong size) noexcept;
+        
+        //! @internal
+        void measure(TextBuffer const& buffer, const ulong line, Paragraph& paragraph) const noexcept;
+        
+        //! @internal
+        void measure(TextBuffer const& buffer, uNode const& node, const ulong offset) noexcept;
+        
+        //! @internal
+        Paragraph const& getParagraph(TextBuffer const& buffer, ulong line, ulong& row) noexcept;
+        
+        //! @internal
+        ulong getLine(ulong index, ulong& row) const noexcept;
+        
+        //! @internal
+        void update(TextBuffer const& buffer) noexcept;
+        
+        //! @internal
+        double getOffset(const double width) const noexcept;
+        
+    public:
+        
+        //! Constructor.
+        /** The function initializes an empty layout.
+         */
+        TextLayout() noexcept;
+        
+        //! Destructor.
+        /** The function frees the layout.
+         */
+        ~TextLayout() noexcept;
+        
+        //! Sets the font.
+        /** The function sets the font of the layout and invalidates all the paragraphs.
+         @param font The font.
+         */
+        void setFont(Font const& font) noexcept;
+        
+        //! Retrieves the font of a face.
+        /** The function retrieves the font of the layout with a font style, the fonts of the styles are created once when the font of the layout changes.
+         @param face The font style.
+         @return The font.
+         */
+        inline Font const& getFont(const Font::Style face) const noexcept {return m_faces[face & 7u];}
+        
+        //! Sets the styles.
+        /** The function sets the styles of the text, the characters are measured with the font style of their run. The styles must cover the characters of the buffer and outlive the layout, or be detached with a null pointer. The function invalidates all the paragraphs, the layout must be notified of the lines whose styles change like of an edit.
+         @param styles The styles or null to measure all the characters with the font of the layout.
+         */
+        void setStyles(TextStyles const* styles) noexcept;
+        
+        //! Sets the width.
+        /** The function sets the width of the layout, it's the limit of the wrapped lines and the reference of the justification. If the width changes and the lines are wrapped, all the paragraphs are invalidated.
+         @param width The width.
+         */
+        void setWidth(const double width) noexcept;
+        
+        //! Sets if the lines are wrapped.
+        /** The function sets if the lines are wrapped within the width of the layout.
+         @param wrap True if the lines should be wrapped, otherwise false.
+         */
+        void setWrapped(const bool wrap) noexcept;
+        
+        //! Sets the height of the lines.
+        /** The function sets the height of the lines, the paragraphs don't need to be laid out again.
+         @param height The height.
+         */
+        void setLineHeight(const double height) noexcept;
+        
+        //! Sets the justification.
+        /** The function sets the horizontal justification of the lines, the paragraphs don't need to be laid out again.
+         @param justification The justification.
+         */
+        void setJustification(const Font::Justification justification) noexcept;
+        
+        //! Invalidates the layout.
+        /** The function invalidates all the paragraphs, the number of paragraphs will match the buffer on the next query. The function visits all the paragraphs, it should only be used when the font or the wrapping changes.
+         */
+        void invalidate() noexcept;
+        
+        //! Notifies the layout that lines have been replaced.
+        /** The function must be called after each edit of the buffer. The lines from first to first + removed of the old text have been replaced by the lines from first to first + inserted of the new text, only these paragraphs will be laid out again. The rows of the other paragraphs are kept, the function is logarithmic in the number of lines.
+         @param first       The index of the first line modified.
+         @param removed     The number of line breaks removed.
+         @param inserted    The number of line breaks inserted.
+         */
+        void replace(const ulong first, const ulong removed, const ulong inserted) noexcept;
+        
+        //! Retrieves the number of rows.
+        /** The function retrieves the number of displayed lines, wrapped lines included.
+         @param buffer The buffer.
+         @return The number of rows.
+         */
+        ulong getNumberOfRows(TextBuffer const& buffer) noexcept;
+        
+        //! Retrieves the row at an ordinate.
+        /** The function retrieves the index of the row that contains an ordinate, the ordinates outside the text give the first or the last row.
+         @param buffer  The buffer.
+         @param y       The ordinate.
+         @return The index of the row.
+         */
+        ulong getRowIndex(TextBuffer const& buffer, const double y) noexcept;
+        
+        //! Retrieves the row of a character.
+        /** The function retrieves the index of the row that contains a character.
+         @param buffer  The buffer.
+         @param pos     The position of the character.
+         @return The index of the row.
+         */
+        ulong getCharacterRow(TextBuffer const& buffer, const ulong pos) noexcept;
+        
+        //! Retrieves the first row of a line.
+        /** The function retrieves the index of the first row of a line of the buffer, the lines after the last one give the number of rows.
+         @param buffer  The buffer.
+         @param line    The index of the line.
+         @return The index of the row.
+         */
+        ulong getLineRow(TextBuffer const& buffer, const ulong line) noexcept;
+        
+        //! Retrieves a row.
+        /** The function retrieves the range of characters and the position of a row.
+         @param buffer  The buffer.
+         @param index   The index of the row.
+         @return The row.
+         */
+        Row getRow(TextBuffer const& buffer, const ulong index) noexcept;
+        
+        //! Retrieves the size of the text.
+        /** The function retrieves the size of the text laid out. When the lines aren't wrapped, the width only accounts for the paragraphs that have been measured.
+         @param buffer The buffer.
+         @return The size.
+         */
+        Size getSize(TextBuffer const& buffer) noexcept;
+        
+        //! Retrieves the position of a character.
+        /** The function retrieves the top left corner of the character at a position, a position at the end of the buffer is placed after the last character.
+         @param buffer  The buffer.
+         @param pos     The position of the character.
+         @return The point.
+         */
+        Point getPosition(TextBuffer const& buffer, const ulong pos) noexcept;
+        
+        //! Retrieves the caret position under a point.
+        /** The function retrieves the position of the caret that is the closest of a point.
+         @param buffer  The buffer.
+         @param pt      The point.
+         @return The position of the caret.
+         */
+        ulong getCaret(TextBuffer const& buffer, Point const& pt) noexcept;
+    };
+}
+
+#endif
@@ -0,0 +1,261 @@
+/*
+ ==============================================================================
+ 
+ This file is part of the KIWI library.
+ Copyright (c) 2014 Pierre Guillot & Eliott Paris.
+ 
+ Permission is granted to use this software under the terms of either:
+ a) the GPL v2 (or any later version)
+ b) the Affero GPL v3
+ 
+ Details of these licenses can be found at: www.gnu.org/licenses
+ 
+ KIWI is distributed in the hope that it will be useful, but WITHOUT ANY
+ WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ 
+ ------------------------------------------------------------------------------
+ 
+ To release a closed-source product which uses KIWI, contact : guillotpierre6@gmail.com
+ 
+ ==============================================================================
+ */
+
+
+#include "KiwiGuiTextStyles.h"
+
+namespace Kiwi
+{
+    // ================================================================================ //
+    //                                      TEXT STYLES                                 //
+    // ================================================================================ //
+    
+    struct TextStyles::Node
+    {
+        scNode      left;
+        scNode      right;
+        scStyle     style;
+        ulong       length;
+        ulong       size;
+        ulong       runs;
+        uint32_t    priority;
+        
+        Node(scNode const& l, scNode const& r, scStyle const& s, const ulong n, const uint32_t p) noexcept :
+        left(l), right(r), style(s), length(n), size(getSize(l) + n + getSize(r)), runs(getRuns(l) + 1ul + getRuns(r)), priority(p) {}
+        
+        Node(scNode const& l, scNode const& r, Node const& run) noexcept :
+        left(l), right(r), style(run.style), length(run.length), size(getSize(l) + length + getSize(r)), runs(getRuns(l) + 1ul + getRuns(r)), priority(run.priority) {}
+    };
+    
+    TextStyles::TextStyles() noexcept : m_seed(0x85EBCA6Bu)
+    {
+        ;
+    }
+    
+    TextStyles::~TextStyles() noexcept
+    {
+        ;
+    }
+    
+    uint32_t TextStyles::random() noexcept
+    {
+        m_seed ^= m_seed << 13;
+        m_seed ^= m_seed >> 17;
+        m_seed ^= m_seed << 5;
+        return m_seed;
+    }
+    
+    ulong TextStyles::getSize(scNode const& node) noexcept
+    {
+        return node ? node->size : 0ul;
+    }
+    
+    ulong TextStyles::getRuns(scNode const& node) noexcept
+    {
+        return node ? node->runs : 0ul;
+    }
+    
+    bool TextStyles::equals(scStyle const& a, scStyle const& b) noexcept
+    {
+        return a == b || (a && b && *a == *b);
+    }
+    
+    void TextStyles::split(scNode const& node, const ulong pos, scNode& left, scNode& right) noexcept
+    {
+        if(!node)
+        {
+            left = right = nullptr;
+            return;
+        }
+        const ulong lsize = getSize(node->left);
+        if(pos <= lsize)
+        {
+            scNode l;
+            split(node->left, pos, left, l);
+            right = make_shared<const Node>(l, node->right, *node);
+        }
+        else if(pos >= lsize + node->length)
+        {
+            scNode r;
+            split(node->right, pos - lsize - node->length, r, right);
+            left = make_shared<const Node>(node->left, r, *node);
+        }
+        else
+        {
+            // The run is cut in two runs that keep the priority of the node.
+            const ulong cut = pos - lsize;
+            left  = make_shared<const Node>(node->left, nullptr, node->style, cut, node->priority);
+            right = make_shared<const Node>(nullptr, node->right, node->style, node->length - cut, node->priority);
+        }
+    }
+    
+    TextStyles::scNode TextStyles::merge(scNode const& left, scNode const& right) noexcept
+    {
+        if(!left)
+        {
+            return right;
+        }
+        else if(!right)
+        {
+            return left;
+        }
+        else if(left->priority > right->priority)
+        {
+            return make_shared<const Node>(left->left, merge(left->right, right), *left);
+        }
+        else
+        {
+            return make_shared<const Node>(merge(left, right->left), right->right, *right);
+        }
+    }
+    
+    TextStyles::scNode TextStyles::join(scNode const& left, scNode const& right) noexcept
+    {
+        if(left && right)
+        {
+            Node const* last = left.get();
+            while(last->right)
+            {
+                last = last->right.get();
+            }
+            Node const* first = right.get();
+            while(first->left)
+            {
+                first = first->left.get();
+            }
+            
+            // Two runs with the same style that follow each other are fused.
+            if(equals(last->style, first->style))
+            {
+                scNode l, previous, next, r;
+                split(left, getSize(left) - last->length, l, previous);
+                split(right, first->length, next, r);
+                return merge(merge(l, make_shared<const Node>(nullptr, nullptr, previous->style, previous->length + next->length, previous->priority)), r);
+            }
+        }
+        return merge(left, right);
+    }
+    
+    TextStyles::Node const* TextStyles::locate(scNode const& root, ulong pos, ulong& start) noexcept
+    {
+        Node const* node = root.get();
+        start = 0ul;
+        while(node)
+        {
+            const ulong lsize = getSize(node->left);
+            if(pos < lsize)
+            {
+                node = node->left.get();
+            }
+            else if(pos < lsize + node->length)
+            {
+                start += lsize;
+                return node;
+            }
+            else
+            {
+                start += lsize + node->length;
+                pos   -= lsize + node->length;
+                node   = node->right.get();
+            }
+        }
+        return nullptr;
+    }
+    
+    void TextStyles::visit(Node const* node, const ulong offset, const ulong pos, const ulong end, function<void(ulong, ulong, scStyle const&)> const& f) noexcept
+    {
+        if(node)
+        {
+            const ulong start = offset + getSize(node->left);
+            const ulong stop  = start + node->length;
+            if(pos < start)
+            {
+                visit(node->left.get(), offset, pos, end, f);
+            }
+            if(pos < stop && end > start)
+            {
+                const ulong first = max(pos, start);
+                f(first, min(end, stop) - first, node->style);
+            }
+            if(end > stop)
+            {
+                visit(node->right.get(), stop, pos, end, f);
+            }
+        }
+    }
+    
+    void TextStyles::reset(const ulong size) noexcept
+    {
+        m_root = size ? make_shared<const Node>(nullptr, nullptr, nullptr, size, random()) : nullptr;
+    }
+    
+    void TextStyles::replace(const ulong pos, const ulong removed, const ulong inserted) noexcept
+    {
+        const ulong total = size();
+        const ulong first = min(pos, total);
+        scNode left, tail, middle, right;
+        split(m_root, first, left, tail);
+        split(tail, min(removed, total - first), middle, right);
+        if(inserted)
+        {
+            // The inserted characters take the style of the character before them, like typed characters.
+            ulong start;
+            Node const* node = left ? locate(left, getSize(left) - 1ul, start) : locate(right, 0ul, start);
+            const scStyle style = node ? node->style : nullptr;
+            m_root = join(join(left, make_shared<const Node>(nullptr, nullptr, style, inserted, random())), right);
+        }
+        else
+        {
+            m_root = join(left, right);
+        }
+    }
+    
+    void TextStyles::setStyle(const ulong pos, const ulong size, scStyle const& style) noexcept
+    {
+        const ulong total = getSize(m_root);
+        if(size && pos < total)
+        {
+            const ulong n = min(size, total - pos);
+            scNode left, tail, middle, right;
+            split(m_root, pos, left, tail);
+            split(tail, n, middle, right);
+            m_root = join(join(left, make_shared<const Node>(nullptr, nullptr, style, n, random())), right);
+        }
+    }
+    
+    TextStyles::scStyle TextStyles::getStyle(const ulong pos) const noexcept
+    {
+        ulong start;
+        Node const* node = locate(m_root, pos, start);
+        return node ? node->style : nullptr;
+    }
+    
+    void TextStyles::visit(const ulong pos, const ulong size, function<void(ulong, ulong, scStyle const&)> const& f) const noexcept
+    {
+        const ulong total = getSize(m_root);
+        if(size && pos < total)
+        {
+            visit(m_root.get(), 0ul, pos, pos + min(size, total - pos), f);
+        }
+    }
+}
@@ -0,0 +1,155 @@
+/*
+ ==============================================================================
+ 
+ This file is part of the KIWI library.
+ Copyright (c) 2014 Pierre Guillot & Eliott Paris.
+ 
+ Permission is granted to use this software under the terms of either:
+ a) the GPL v2 (or any later version)
+ b) the Affero GPL v3
+ 
+ Details of these licenses can be found at: www.gnu.org/licenses
+ 
+ KIWI is distributed in the hope that it will be useful, but WITHOUT ANY
+ WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ 
+ ------------------------------------------------------------------------------
+ 
+ To release a closed-source product which uses KIWI, contact : guillotpierre6@gmail.com
+ 
+ ==============================================================================
+ */
+
+
+#ifndef __DEF_KIWI_GUI_TEXT_STYLES__
+#define __DEF_KIWI_GUI_TEXT_STYLES__
+
+#include "KiwiGuiTextHistory.h"
+
+namespace Kiwi
+{
+    // ================================================================================ //
+    //                                      TEXT STYLES                                 //
+    // ================================================================================ //
+    
+    //! The text styles.
+    /** The text styles stores the attributes of a text as runs, a run is a number of consecutive characters that share a style. The runs are stored in a balanced tree (an implicit treap) where a run is only located by the lengths of the runs before it, so inserting or erasing characters shifts all the following runs in logarithmic time. The runs that follow each other with the same style are fused.
+     */
+    class TextStyles
+    {
+    public:
+        
+        //! A style.
+        /** The style defines the color, the background color and the font style of a run.
+         */
+        struct Style
+        {
+            Color       color;
+            Color       background;
+            Font::Style face;
+            
+            inline bool operator==(Style const& other) const noexcept
+            {
+                return color == other.color && background == other.background && face == other.face;
+            }
+        };
+        typedef shared_ptr<const Style> scStyle;
+        
+    private:
+        struct Node;
+        typedef shared_ptr<const Node> scNode;
+        
+        scNode      m_root;
+        uint32_t    m_seed;
+        
+        //! @internal
+        uint32_t random() noexcept;
+        
+        //! @internal
+        static ulong getSize(scNode const& node) noexcept;
+        
+        //! @internal
+        static ulong getRuns(scNode const& node) noexcept;
+        
+        //! @internal
+        static bool equals(scStyle const& a, scStyle const& b) noexcept;
+        
+        //! @internal
+        static void split(scNode const& node, const ulong pos, scNode& left, scNode& right) noexcept;
+        
+        //! @internal
+        static scNode merge(scNode const& left, scNode const& right) noexcept;
+        
+        //! @internal
+        static scNode join(scNode const& left, scNode const& right) noexcept;
+        
+        //! @internal
+        static Node const* locate(scNode const& root, ulong pos, ulong& start) noexcept;
+        
+        //! @internal
+        static void visit(Node const* node, ulong offset, ulong pos, ulong end, function<void(ulong, ulong, scStyle const&)> const& f) noexcept;
+    public:
+        
+        //! Constructor.
+        /** The function initializes styles without characters.
+         */
+        TextStyles() noexcept;
+        
+        //! Destructor.
+        /** The function does nothing.
+         */
+        ~TextStyles() noexcept;
+        
+        //! Retrieves the number of characters.
+        /** The function retrieves the number of characters covered by the runs.
+         @return The number of characters.
+         */
+        inline ulong size() const noexcept {return getSize(m_root);}
+        
+        //! Retrieves the number of runs.
+        /** The function retrieves the number of runs.
+         @return The number of runs.
+         */
+        inline ulong getNumberOfRuns() const noexcept {return getRuns(m_root);}
+        
+        //! Resets the styles.
+        /** The function removes all the styles, the characters are covered by one run with the default style.
+         @param size The number of characters.
+         */
+        void reset(const ulong size) noexcept;
+        
+        //! Updates the runs after an edit.
+        /** The function removes the runs of the removed characters and extends the run before the edit with the inserted characters, or the run after the edit at the start of the text.
+         @param pos         The position of the edit.
+         @param removed     The number of characters removed.
+         @param inserted    The number of characters inserted.
+         */
+        void replace(const ulong pos, const ulong removed, const ulong inserted) noexcept;
+        
+        //! Sets the style of a range of characters.
+        /** The function sets the style of a range of characters, the range becomes one run that is fused with its neighbours if they have the same style.
+         @param pos     The position of the first character.
+         @param size    The number of characters.
+         @param style   The style or null for the default style.
+         */
+        void setStyle(const ulong pos, const ulong size, scStyle const& style) noexcept;
+        
+        //! Retrieves the style of a character.
+        /** The function retrieves the style of the character at a position.
+         @param pos The position.
+         @return The style or null for the default style.
+         */
+        scStyle getStyle(const ulong pos) const noexcept;
+        
+        //! Visits the runs of a range of characters.
+        /** The function calls a function for each run that overlaps a range of characters with the part of the run within the range, only the runs of the range are visited.
+         @param pos     The position of the first character.
+         @param size    The number of characters.
+         @param f       The function that receives the position, the number of characters and the style of a run.
+         */
+        void visit(const ulong pos, const ulong size, function<void(ulong, ulong, scStyle const&)> const& f) const noexcept;
+    };
+}
+
+#endif
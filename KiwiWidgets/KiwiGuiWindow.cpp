@@ -30,12 +30,10 @@ namespace Kiwi
     //                                  GUI WINDOW                                      //
     // ================================================================================ //
 	
-    GuiWindow::GuiWindow(sGuiContext context, const ulong zones, Color const& color) noexcept : GuiModel(context),
+    GuiWindow::GuiWindow(sGuiContext context, const ulong zones) noexcept : GuiModel(context),
     m_resizer(make_shared<GuiResizer>(context, zones)),
-    m_color(Colors::white),
     m_roundness(4.)
     {
-        setBackgroundColor(color);
         addChild(m_resizer);
     }
     
@@ -44,15 +42,6 @@ namespace Kiwi
         ;
     }
     
-    void GuiWindow::setBackgroundColor(Color const& color) noexcept
-    {
-        if(m_color != color)
-        {
-            m_color = color;
-            redraw();
-        }
-    }
-    
     void GuiWindow::setRoundness(double roundness) noexcept
     {
         if(roundness < 0.) roundness = 0.;
@@ -184,9 +173,10 @@ namespace Kiwi
     void GuiWindow::Controller::draw(sGuiView view, Sketch& sketch)
     {
         sGuiWindow window(getWindow());
-        if(window)
+        sGuiContext context(getContext());
+        if(window && context)
         {
-            sketch.setColor(window->getBackgroundColor());
+            sketch.setColor(context->getThemeColor(GuiTheme::Background));
             sketch.fillRectangle(getBounds().withZeroOrigin(), window->getRoundness());
         }
     }
@@ -194,9 +184,10 @@ namespace Kiwi
     void GuiWindow::Controller::drawOver(sGuiView view, Sketch& sketch)
     {
         sGuiWindow window = getWindow();
-        if(window)
+        sGuiContext context(getContext());
+        if(window && context)
         {
-            sketch.setColor(window->getBackgroundColor().contrasted(0.8));
+            sketch.setColor(context->getThemeColor(GuiTheme::Border));
             sketch.setLineWidth(3.);
             sketch.drawRectangle(getBounds().withZeroOrigin().reduced(1.5), window->getRoundness());
         }
@@ -280,17 +271,13 @@ namespace Kiwi
     
     GuiWindow::Header::Header(sGuiContext context,
                               string const& title,
-                              ulong const buttons,
-                              Color const& bgcolor,
-                              Color const& txtcolor) noexcept :
+                              ulong const buttons) noexcept :
     GuiModel(context),
-    m_button_close(make_shared<GuiButton>(getContext(), Colors::red.brighter(0.4))),
-    m_button_minimize(make_shared<GuiButton>(getContext(), Colors::yellow.brighter(0.4))),
-    m_button_maximize(make_shared<GuiButton>(getContext(), Colors::green.brighter(0.4))),
+    m_button_close(make_shared<GuiButton>(getContext(), GuiTheme::Close)),
+    m_button_minimize(make_shared<GuiButton>(getContext(), GuiTheme::Minimize)),
+    m_button_maximize(make_shared<GuiButton>(getContext(), GuiTheme::Maximize)),
     m_title(title),
-    m_buttons(noButton),
-    m_bg_color(bgcolor),
-    m_txt_color(txtcolor)
+    m_buttons(noButton)
     {
         setButtons(buttons);
     }
@@ -341,41 +328,26 @@ namespace Kiwi
         }
     }
     
-    void GuiWindow::Header::setBackgroundColor(Color const& color) noexcept
-    {
-        if(color != m_bg_color)
-        {
-            m_bg_color = color;
-            redraw();
-        }
-    }
-    
-    void GuiWindow::Header::setTextColor(Color const& color) noexcept
-    {
-        if(color != m_txt_color)
-        {
-            m_txt_color = color;
-            redraw();
-        }
-    }
-    
     void GuiWindow::Header::draw(sController ctrl, Sketch& sketch) const
     {
-        const Rectangle bounds = ctrl->getBounds().withZeroOrigin();
-        sketch.fillAll(m_bg_color.contrasted(0.8));
-        sketch.setColor(m_bg_color.contrasted(0.4));
-        //sketch.setColor(m_txt_color);
-        Font font;
-        font.setHeight(bounds.height() * 0.6);
-        font.setStyle(Font::Bold);
-        sketch.setFont(font);
-        if(font.getLineWidth(m_title) < bounds.width() - 120)
-        {
-            sketch.drawTextLine(m_title, bounds, Font::Centred, false);
-        }
-        else
-        {
-            sketch.drawTextLine(m_title, 60., 0., bounds.width() - 64., bounds.height(), Font::Left, true);
+        sGuiContext context = getContext();
+        if(context)
+        {
+            const Rectangle bounds = ctrl->getBounds().withZeroOrigin();
+            sketch.fillAll(context->getThemeColor(GuiTheme::Header));
+            sketch.setColor(context->getThemeColor(GuiTheme::Header, GuiTheme::Contrast));
+            Font font;
+            font.setHeight(bounds.height() * 0.6);
+            font.setStyle(Font::Bold);
+            sketch.setFont(font);
+            if(font.getLineWidth(m_title) < bounds.width() - 120)
+            {
+                sketch.drawTextLine(m_title, bounds, Font::Centred, false);
+            }
+            else
+            {
+                sketch.drawTextLine(m_title, 60., 0., bounds.width() - 64., bounds.height(), Font::Left, true);
+            }
         }
     }
     
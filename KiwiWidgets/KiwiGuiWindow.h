@@ -24,7 +24,7 @@
 #ifndef __DEF_KIWI_GUI_WINDOW__
 #define __DEF_KIWI_GUI_WINDOW__
 
-#include "KiwiGuiTextEditor.h"
+#include "KiwiGuiLabel.h"
 
 namespace Kiwi
 {
@@ -50,7 +50,6 @@ namespace Kiwi
         const sGuiResizer   m_resizer;
         sHeader             m_header;
         sGuiModel           m_content;
-        Color               m_color;
         double              m_roundness;
     public:
         
@@ -59,29 +58,16 @@ namespace Kiwi
          @param context The context.
          @param title   The title of the window.
          @param zones   The title of the window.
-         @param color   The background color of the window.
          @param buttons The buttons available at the top of the window.
          @param show    If the window should be popup.
          */
-        GuiWindow(sGuiContext context, const ulong zones = GuiResizer::All, Color const& color = Colors::grey) noexcept;
+        GuiWindow(sGuiContext context, const ulong zones = GuiResizer::All) noexcept;
         
         //! The window destructor.
         /** The function does nothing.
          */
         virtual ~GuiWindow() noexcept;
         
-        //! Sets the background color of the window.
-        /** The function sets the background color of the window.
-         @param color The background color.
-         */
-        void setBackgroundColor(Color const& color) noexcept;
-        
-        //! Retreives the background color of the window.
-        /** The function retreives the background color of the window.
-         @return The background color.
-         */
-        inline Color getBackgroundColor() const noexcept {return m_color;}
-        
         //! Set the roundness of the window's corners.
         /** The function sets the roundness of the window's corners.
          @param roundness The roundness of the corners.
@@ -267,8 +253,6 @@ namespace Kiwi
         const sGuiButton m_button_maximize;
         string          m_title;
         ulong           m_buttons;
-        Color           m_bg_color;
-        Color           m_txt_color;
         
     public:
         
@@ -288,14 +272,10 @@ namespace Kiwi
          @param context     The context.
          @param title       The title to display.
          @param buttons     The buttons to display.
-         @param bgcolor     The background color.
-         @param txtcolor    The text color.
          */
         Header(sGuiContext context,
                string const& title  = "untitled",
-               ulong const buttons  = allButtons,
-               Color const& bgcolor = Colors::grey,
-               Color const& txtcolor= Colors::black) noexcept;
+               ulong const buttons  = allButtons) noexcept;
         
         //! The container destructor.
         /** The function does nothing.
@@ -314,18 +294,6 @@ namespace Kiwi
          */
         inline ulong getButtons() const noexcept {return m_buttons;}
         
-        //! Retreives the background color of the header.
-        /** The function retreives the background color of the header.
-         @return The background color.
-         */
-        inline Color getBackgroundColor() const noexcept {return m_bg_color;}
-        
-        //! Retreives the text color of the header.
-        /** The function retreives the text color of the header.
-         @return The text color.
-         */
-        inline Color getTextColor() const noexcept{return m_txt_color;}
-        
         //! Retreives the close button of the header.
         /** The function retreives the close button of the header.
          @return The close button.
@@ -356,18 +324,6 @@ namespace Kiwi
          */
         void setButtons(const ulong buttons) noexcept;
         
-        //! Sets the background color of the header.
-        /** The function sets the background color of the header.
-         @param color The background color.
-         */
-        void setBackgroundColor(Color const& color) noexcept;
-        
-        //! Sets the text color of the header.
-        /** The function sets the text color of the header.
-         @param color The text color.
-         */
-        void setTextColor(Color const& color) noexcept;
-        
         //! The draw method that should be override.
         /** The function shoulds draw some stuff.
          @param ctrl    The controller.